@@ -0,0 +1,65 @@
+#include <pebble.h>
+#include "background_cache.h"
+
+static GBitmap *s_cache_bitmap;
+static bool s_cache_valid;
+static int s_cache_hits;
+static int s_cache_misses;
+
+// Draws the cached background and returns true, or returns false if it has to be re-rendered.
+bool background_cache_draw(GContext *ctx, GRect bounds) {
+  if (!s_cache_valid) {
+    s_cache_misses++;
+    return false;
+  }
+  s_cache_hits++;
+  graphics_draw_bitmap_in_rect(ctx, s_cache_bitmap, bounds);
+  return true;
+}
+// Copies what has been drawn to the frame buffer so far into the cache.
+void background_cache_store(GContext *ctx) {
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return;
+  }
+  GRect frame_bounds = gbitmap_get_bounds(frame_buffer);
+  if (!s_cache_bitmap) {
+    s_cache_bitmap = gbitmap_create_blank(frame_bounds.size, gbitmap_get_format(frame_buffer));
+  }
+  if (s_cache_bitmap) {
+#if defined(PBL_ROUND)
+    // The circular frame buffer's rows have different lengths; copy each one's visible span.
+    for (int y = 0; y < frame_bounds.size.h; y++) {
+      GBitmapDataRowInfo source = gbitmap_get_data_row_info(frame_buffer, y);
+      GBitmapDataRowInfo destination = gbitmap_get_data_row_info(s_cache_bitmap, y);
+      memcpy(destination.data + source.min_x, source.data + source.min_x, source.max_x - source.min_x + 1);
+    }
+#else
+    uint8_t *source = gbitmap_get_data(frame_buffer);
+    uint8_t *destination = gbitmap_get_data(s_cache_bitmap);
+    uint16_t source_row = gbitmap_get_bytes_per_row(frame_buffer);
+    uint16_t destination_row = gbitmap_get_bytes_per_row(s_cache_bitmap);
+    for (int y = 0; y < frame_bounds.size.h; y++) {
+      memcpy(destination + (y * destination_row), source + (y * source_row), MIN(source_row, destination_row));
+    }
+#endif
+    s_cache_valid = true;
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+}
+void background_cache_invalidate() {
+  s_cache_valid = false;
+}
+void background_cache_destroy() {
+  if (s_cache_bitmap) {
+    gbitmap_destroy(s_cache_bitmap);
+    s_cache_bitmap = NULL;
+  }
+  s_cache_valid = false;
+}
+int background_cache_get_hits() {
+  return s_cache_hits;
+}
+int background_cache_get_misses() {
+  return s_cache_misses;
+}
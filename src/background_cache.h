@@ -0,0 +1,11 @@
+#pragma once
+#include <pebble.h>
+
+// A copy of the composited static background (clockface and info widgets),
+// captured from the frame buffer and blitted back until it is invalidated.
+bool background_cache_draw(GContext *ctx, GRect bounds);
+void background_cache_store(GContext *ctx);
+void background_cache_invalidate();
+void background_cache_destroy();
+int background_cache_get_hits();
+int background_cache_get_misses();
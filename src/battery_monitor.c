@@ -0,0 +1,96 @@
+#include <pebble.h>
+#include "battery_monitor.h"
+
+// Ring buffer of readings taken while discharging; cleared whenever the watch charges.
+static BatterySample s_samples[BATTERY_SAMPLE_COUNT];
+static int s_sample_count;
+static int s_sample_next;
+
+static BatteryChargeState s_charge_state;
+
+// Time spent on second ticks since the last sample, and when the current tick mode started.
+static bool s_seconds_active;
+static time_t s_mode_since;
+static time_t s_seconds_time;
+
+// The battery bar shortens one step for every 10% of depletion.
+static int charge_bucket(BatteryChargeState charge_state) {
+  return (100 - charge_state.charge_percent) / 10;
+}
+static void account_tick_mode(time_t now) {
+  if (s_seconds_active) {
+    s_seconds_time += now - s_mode_since;
+  }
+  s_mode_since = now;
+}
+static void record_sample(time_t now, uint8_t charge_percent) {
+  account_tick_mode(now);
+  int seconds_share = 0;
+  if (s_sample_count > 0) {
+    const BatterySample *previous = &s_samples[(s_sample_next + BATTERY_SAMPLE_COUNT - 1) % BATTERY_SAMPLE_COUNT];
+    time_t elapsed = now - previous->time;
+    seconds_share = (elapsed > 0) ? (int) ((s_seconds_time * 100) / elapsed) : 0;
+  }
+  s_samples[s_sample_next] = (BatterySample) {
+    .time = now,
+    .charge_percent = charge_percent,
+    .seconds_share = MIN(seconds_share, 100),
+  };
+  s_sample_next = (s_sample_next + 1) % BATTERY_SAMPLE_COUNT;
+  s_sample_count = MIN(s_sample_count + 1, BATTERY_SAMPLE_COUNT);
+  s_seconds_time = 0;
+}
+void battery_monitor_init() {
+  s_charge_state = battery_state_service_peek();
+  s_mode_since = time(NULL);
+  if (!s_charge_state.is_charging) {
+    record_sample(s_mode_since, s_charge_state.charge_percent);
+  }
+}
+// Records a new charge state and returns true if the battery bar needs to be redrawn.
+bool battery_monitor_update(BatteryChargeState charge_state) {
+  bool changed = charge_bucket(charge_state) != charge_bucket(s_charge_state) ||
+                 charge_state.is_charging != s_charge_state.is_charging;
+  time_t now = time(NULL);
+  if (charge_state.is_charging) {
+    s_sample_count = 0;
+    s_sample_next = 0;
+    account_tick_mode(now);
+    s_seconds_time = 0;
+  } else if (s_charge_state.is_charging || charge_state.charge_percent != s_charge_state.charge_percent ||
+             s_sample_count == 0) {
+    record_sample(now, charge_state.charge_percent);
+  }
+  s_charge_state = charge_state;
+  return changed;
+}
+BatteryChargeState battery_monitor_get_state() {
+  return s_charge_state;
+}
+void battery_monitor_set_seconds_active(bool active) {
+  if (active == s_seconds_active) {
+    return;
+  }
+  account_tick_mode(time(NULL));
+  s_seconds_active = active;
+}
+// Percent of charge used per day across the sampled intervals spent mostly with
+// (or without) second ticks, or -1 if there is not enough data yet.
+int battery_monitor_get_drain_rate(bool seconds_active) {
+  int drained = 0;
+  time_t elapsed = 0;
+  for (int i = 1; i < s_sample_count; i++) {
+    int oldest = (s_sample_next + BATTERY_SAMPLE_COUNT - s_sample_count) % BATTERY_SAMPLE_COUNT;
+    const BatterySample *previous = &s_samples[(oldest + i - 1) % BATTERY_SAMPLE_COUNT];
+    const BatterySample *current = &s_samples[(oldest + i) % BATTERY_SAMPLE_COUNT];
+    if ((current->seconds_share >= 50) != seconds_active) {
+      continue;
+    }
+    drained += previous->charge_percent - current->charge_percent;
+    elapsed += current->time - previous->time;
+  }
+  if (elapsed <= 0) {
+    return -1;
+  }
+  return (int) ((drained * 24 * 60 * 60) / elapsed);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <pebble.h>
+
+#define BATTERY_SAMPLE_COUNT 16
+
+// A charge reading, with the share of the time since the previous reading
+// that the watchface spent on second ticks.
+typedef struct {
+  time_t time;
+  uint8_t charge_percent;
+  uint8_t seconds_share;
+} BatterySample;
+
+void battery_monitor_init();
+bool battery_monitor_update(BatteryChargeState charge_state);
+BatteryChargeState battery_monitor_get_state();
+void battery_monitor_set_seconds_active(bool active);
+int battery_monitor_get_drain_rate(bool seconds_active);
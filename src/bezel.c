@@ -0,0 +1,69 @@
+#include <pebble.h>
+#include "bezel.h"
+
+// Where the tip of a hand `length' pixels long lands, rotated the way gpath_rotate_to() does.
+static GPoint tip_point(int length, int32_t sine, int32_t cosine, GPoint center) {
+  return GPoint(center.x + (length * sine / TRIG_MAX_RATIO), center.y - (length * cosine / TRIG_MAX_RATIO));
+}
+// Whether the display shows the pixel at `point': round displays show the pixels whose centers
+// lie inside the circle inscribed in the bounds.
+static bool shows_pixel(GRect bounds, GPoint point) {
+#if defined(PBL_ROUND)
+  int32_t dx = 2 * (point.x - bounds.origin.x) + 1 - bounds.size.w;
+  int32_t dy = 2 * (point.y - bounds.origin.y) + 1 - bounds.size.h;
+  int32_t diameter = MIN(bounds.size.w, bounds.size.h);
+  return dx * dx + dy * dy <= diameter * diameter;
+#else
+  return grect_contains_point(&bounds, &point);
+#endif
+}
+// Distance in pixels from the center of `bounds' to the bezel along `angle'
+// (0 is 12 o'clock), in integer math only. Round displays are a circle
+// inscribed in the bounds; rectangular ones end at whichever edge the ray
+// reaches first. The tip of a hand this long is the last pixel the display
+// shows along the ray.
+int bezel_distance(int32_t angle, GRect bounds) {
+  int32_t half_width = bounds.size.w / 2;
+  int32_t half_height = bounds.size.h / 2;
+  int32_t sine = sin_lookup(angle);
+  int32_t cosine = cos_lookup(angle);
+#if defined(PBL_ROUND)
+  int length = MIN(half_width, half_height);
+#else
+  int32_t sin_ratio = ABS(sine);
+  int32_t cos_ratio = ABS(cosine);
+  int length;
+  // half_width / sin < half_height / cos, compared without dividing.
+  if (half_width * cos_ratio < half_height * sin_ratio) {
+    length = (half_width * TRIG_MAX_RATIO) / sin_ratio;
+  } else {
+    length = (half_height * TRIG_MAX_RATIO) / cos_ratio;
+  }
+#endif
+  // Rounding the tip to a pixel can leave it off the screen or short of the edge, so step to the
+  // last pixel shown along the ray, then back to the shortest length that still reaches it.
+  GPoint center = grect_center_point(&bounds);
+  while (length > 0 && !shows_pixel(bounds, tip_point(length, sine, cosine, center))) {
+    length--;
+  }
+  while (shows_pixel(bounds, tip_point(length + 1, sine, cosine, center))) {
+    length++;
+  }
+  GPoint tip = tip_point(length, sine, cosine, center);
+  while (length > 0) {
+    GPoint shorter = tip_point(length - 1, sine, cosine, center);
+    if (!gpoint_equal(&shorter, &tip)) {
+      break;
+    }
+    length--;
+  }
+  return length;
+}
+// Fills `lengths' with the bezel distance for `steps' evenly spaced angles, so draw procs only index it.
+// The angles are rounded down the same way as the hands' rotations, so each length is for the exact
+// angle its hand is drawn at.
+void bezel_build_table(uint8_t *lengths, int steps, GRect bounds) {
+  for (int step = 0; step < steps; step++) {
+    lengths[step] = MIN(bezel_distance((TRIG_MAX_ANGLE / steps) * step, bounds), UINT8_MAX);
+  }
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <pebble.h>
+
+#define MINUTE_HAND_STEPS 60
+#define HOUR_HAND_STEPS 720
+
+int bezel_distance(int32_t angle, GRect bounds);
+void bezel_build_table(uint8_t *lengths, int steps, GRect bounds);
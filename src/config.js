@@ -1,14 +1,44 @@
-Pebble.addEventListener("ready", function() {
-  Pebble.addEventListener("showConfiguration", function() {
-    Pebble.openURL('http://smognus.github.io/variable-hands-config/index.html');
+var PROFILE_SLOTS = ['background', 'hour hand', 'minute hand', 'second hand', 'tick handler'];
+
+// Logs the frame profile a watch built with VARIABLE_HANDS_PROFILER=1 sends back;
+// each slot is count, min, avg, max and p95 in milliseconds as little endian uint16.
+function logProfileSummary(summary) {
+  var slots = summary[0];
+  for (var slot = 0; slot < slots; slot++) {
+    var values = [];
+    for (var i = 0; i < 5; i++) {
+      var offset = 1 + (slot * 5 + i) * 2;
+      values.push(summary[offset] | (summary[offset + 1] << 8));
+    }
+    console.log('Profile ' + (PROFILE_SLOTS[slot] || slot) + ': n=' + values[0] + ' min=' + values[1] +
+                'ms avg=' + values[2] + 'ms max=' + values[3] + 'ms p95=' + values[4] + 'ms');
+  }
+}
+
+// Packs [{days, start, end}] windows, with times in minutes after midnight and
+// `days' a bitmask with bit 0 for Sunday, into the byte layout the watch reads.
+function packSchedule(windows) {
+  var bytes = [];
+  windows.slice(0, 4).forEach(function(window) {
+    var start = parseInt(window.start, 10) || 0;
+    var end = parseInt(window.end, 10) || 0;
+    bytes.push(parseInt(window.days, 10) & 0x7f, start & 0xff, start >> 8, end & 0xff, end >> 8);
   });
-  
-  Pebble.addEventListener('webviewclosed', function(e) {
-  // Decode and parse config data as JSON
-  var config_data = JSON.parse(decodeURIComponent(e.response));
-  console.log('Config window returned: ', JSON.stringify(config_data));
-  // Prepare AppMessage payload
-    
+  return bytes;
+}
+
+var POWER_THRESHOLD_SETTINGS = ['powerSecondsThresholdSetting', 'powerInfoThresholdSetting', 'powerStaticThresholdSetting'];
+var SETTINGS_CACHE_KEY = 'acknowledgedSettings';
+var RETRY_BASE_MS = 1000;
+var RETRY_MAX_MS = 60000;
+var RETRY_LIMIT = 8;
+
+// The watch only applies the second hand hours when it gets both, and they replace the
+// schedule, so a change to any of these sends all of them that the page gave.
+var SETTING_GROUPS = [['secondStartSetting', 'secondEndSetting', 'scheduleSetting']];
+
+// Turns what the config page returned into the full AppMessage dictionary.
+function settingsFromConfig(config_data) {
   var dict = {
     'tickSetting': config_data.tickSetting,
     'daySetting': config_data.daySetting,
@@ -21,14 +51,182 @@ Pebble.addEventListener("ready", function() {
     'windowTextColorSetting': parseInt(config_data.windowTextColorSetting, 16),
     'lightThemeSetting': config_data.lightThemeSetting,
     'secondHandColorSetting': parseInt(config_data.secondHandColorSetting, 16),
-    'secondOutlineColorSetting': parseInt(config_data.secondOutlineColorSetting, 16)
+    'secondOutlineColorSetting': parseInt(config_data.secondOutlineColorSetting, 16),
+    'secondModeSetting': parseInt(config_data.secondModeSetting, 10) || 0,
+    'glanceDurationSetting': parseInt(config_data.glanceDurationSetting, 10) || 10,
+    'sweepSetting': parseInt(config_data.sweepSetting, 10) || 0,
+    'handStyleSetting': parseInt(config_data.handStyleSetting, 10) || 0
   };
-    console.log('AppMessage contents:', JSON.stringify(dict));
-  // Send settings to Pebble watchapp
-  Pebble.sendAppMessage(dict, function(){
-    console.log('Sent config data to Pebble');  
+  // Config pages that predate schedules only send the start and end hours.
+  if (config_data.schedule) {
+    dict.scheduleSetting = packSchedule(config_data.schedule);
+  }
+  // Nor do older pages know the power saving thresholds, which the watch then keeps.
+  POWER_THRESHOLD_SETTINGS.forEach(function(key) {
+    var percent = parseInt(config_data[key], 10);
+    if (!isNaN(percent)) {
+      dict[key] = Math.max(0, Math.min(percent, 100));
+    }
+  });
+  return dict;
+}
+
+// The keys of `next' whose values differ from `previous', widened to whole groups.
+function diffSettings(previous, next) {
+  var delta = {};
+  Object.keys(next).forEach(function(key) {
+    if (JSON.stringify(previous[key]) !== JSON.stringify(next[key])) {
+      delta[key] = next[key];
+    }
+  });
+  SETTING_GROUPS.forEach(function(group) {
+    var changed = group.some(function(key) { return key in delta; });
+    group.forEach(function(key) {
+      if (changed && key in next) {
+        delta[key] = next[key];
+      }
+    });
+  });
+  return delta;
+}
+
+// Settings the watch has acknowledged, per watch, so each save only sends what changed.
+function cacheKey() {
+  var token = (typeof Pebble.getWatchToken === 'function') ? Pebble.getWatchToken() : '';
+  return SETTINGS_CACHE_KEY + (token ? '.' + token : '');
+}
+function loadAcknowledged() {
+  try {
+    return JSON.parse(localStorage.getItem(cacheKey())) || {};
+  } catch (e) {
+    return {};
+  }
+}
+function storeAcknowledged(settings) {
+  localStorage.setItem(cacheKey(), JSON.stringify(settings));
+}
+
+// The watch reports at launch whether it still has saved settings. Until it has, or until a
+// save sent everything, the cache may describe settings a reinstall wiped, so saves send every key.
+var cacheTrusted = false;
+
+function handleSettingsState(state) {
+  if (!state) {
+    console.log('Watch is on default settings, dropping the acknowledged settings cache.');
+    localStorage.removeItem(cacheKey());
+  }
+  cacheTrusted = true;
+}
+
+// Only one settings message is in flight. Saves made meanwhile, or while a failed
+// message waits to be retried, collapse into the newest one, which is then diffed
+// against what the watch acknowledged, so nothing a failed message carried is lost.
+var settingsQueue = {
+  pending: null,
+  inFlight: false,
+  attempts: 0,
+  retryTimer: null
+};
+
+function queueSettings(settings) {
+  settingsQueue.pending = settings;
+  if (settingsQueue.retryTimer !== null) {
+    // A new save is worth trying straight away.
+    clearTimeout(settingsQueue.retryTimer);
+    settingsQueue.retryTimer = null;
+    settingsQueue.attempts = 0;
+  }
+  flushSettings();
+}
+
+function flushSettings() {
+  if (settingsQueue.inFlight || settingsQueue.retryTimer !== null || !settingsQueue.pending) {
+    return;
+  }
+  var settings = settingsQueue.pending;
+  var acknowledged = cacheTrusted ? loadAcknowledged() : {};
+  var delta = diffSettings(acknowledged, settings);
+  settingsQueue.pending = null;
+  if (Object.keys(delta).length === 0) {
+    console.log('Settings unchanged, nothing sent.');
+    settingsQueue.attempts = 0;
+    return;
+  }
+  console.log('AppMessage contents:', JSON.stringify(delta));
+  settingsQueue.inFlight = true;
+  Pebble.sendAppMessage(delta, function() {
+    console.log('Sent config data to Pebble');
+    settingsQueue.inFlight = false;
+    settingsQueue.attempts = 0;
+    Object.keys(delta).forEach(function(key) {
+      acknowledged[key] = delta[key];
+    });
+    storeAcknowledged(acknowledged);
+    cacheTrusted = true;
+    flushSettings();
   }, function() {
-    console.log('Failed to send config data!');
+    settingsQueue.inFlight = false;
+    if (!settingsQueue.pending) {
+      settingsQueue.pending = settings;
+    }
+    if (++settingsQueue.attempts > RETRY_LIMIT) {
+      // Given up for now; the next save diffs against the same acknowledged state and resends it.
+      console.log('Failed to send config data, giving up after ' + RETRY_LIMIT + ' retries.');
+      settingsQueue.attempts = 0;
+      if (settingsQueue.pending === settings) {
+        settingsQueue.pending = null;
+      } else {
+        // A save made while this attempt was in flight gets its own retries.
+        flushSettings();
+      }
+      return;
+    }
+    var delay = Math.min(RETRY_BASE_MS * Math.pow(2, settingsQueue.attempts - 1), RETRY_MAX_MS);
+    console.log('Failed to send config data, retrying in ' + delay + 'ms.');
+    settingsQueue.retryTimer = setTimeout(function() {
+      settingsQueue.retryTimer = null;
+      flushSettings();
+    }, delay);
   });
+}
+
+// Set when the watch says at launch that it was built with the profiler.
+var profilerAvailable = false;
+
+// Asks for the frame profile through the settings queue, so it never overlaps a settings
+// message; while one is being sent or retried the profile waits for the next opening.
+function requestProfile() {
+  if (!profilerAvailable || settingsQueue.inFlight || settingsQueue.retryTimer !== null) {
+    return;
+  }
+  settingsQueue.inFlight = true;
+  var done = function() {
+    settingsQueue.inFlight = false;
+    flushSettings();
+  };
+  Pebble.sendAppMessage({'profileRequest': 1}, done, done);
+}
+
+Pebble.addEventListener("ready", function() {
+  Pebble.addEventListener("showConfiguration", function() {
+    requestProfile();
+    Pebble.openURL('http://smognus.github.io/variable-hands-config/index.html');
+  });
+
+  Pebble.addEventListener('appmessage', function(e) {
+    if ('settingsState' in e.payload) {
+      profilerAvailable = !!e.payload.profilerAvailable;
+      handleSettingsState(e.payload.settingsState);
+    }
+    if (e.payload.profileSummary) {
+      logProfileSummary(e.payload.profileSummary);
+    }
+  });
+  
+  Pebble.addEventListener('webviewclosed', function(e) {
+    // Decode and parse config data as JSON
+    var config_data = JSON.parse(decodeURIComponent(e.response));
+    console.log('Config window returned: ', JSON.stringify(config_data));
+    queueSettings(settingsFromConfig(config_data));
   });
-});
\ No newline at end of file
+});
@@ -0,0 +1,120 @@
+#include <pebble.h>
+#include "dither.h"
+
+// Polygons here are hands, which never have more edges than this.
+#define DITHER_MAX_CROSSINGS 12
+
+// Sums the 2-bit channels, 0 to 9, and rounds that to a shade.
+uint8_t dither_shade(GColor color) {
+  int level = color.r + color.g + color.b;
+  return (level * (DITHER_SHADES - 1) + 4) / 9;
+}
+GColor dither_solid(GColor color) {
+#if defined(PBL_BW)
+  if (gcolor_equal(color, GColorClear)) {
+    return color;
+  }
+  return (dither_shade(color) >= (DITHER_SHADES - 1) / 2) ? GColorWhite : GColorBlack;
+#else
+  return color;
+#endif
+}
+#if defined(PBL_BW)
+// A pixel is white when its threshold is below the shade, so shade 2 is a checkerboard.
+static const uint8_t s_thresholds[2][2] = { { 0, 2 }, { 3, 1 } };
+
+static bool is_pattern(uint8_t shade) {
+  return shade > 0 && shade < DITHER_SHADES - 1;
+}
+// A pattern is filled in whichever color most of its pixels are, so the fewest pixels are drawn one by one.
+static GColor base_color(uint8_t shade) {
+  return (shade > (DITHER_SHADES - 1) / 2) ? GColorWhite : GColorBlack;
+}
+// Paints the pixels of `shade' that differ from its base color, from `x0' up to, but not including, `x1'.
+static void draw_pattern_span(GContext *ctx, int y, int x0, int x1, uint8_t shade) {
+  const uint8_t *thresholds = s_thresholds[y & 1];
+  bool base_white = gcolor_equal(base_color(shade), GColorWhite);
+  for (int x = x0; x < x1; x++) {
+    if ((thresholds[x & 1] < shade) != base_white) {
+      graphics_draw_pixel(ctx, GPoint(x, y));
+    }
+  }
+}
+static GColor pattern_color(uint8_t shade) {
+  return gcolor_equal(base_color(shade), GColorWhite) ? GColorBlack : GColorWhite;
+}
+#endif
+void dither_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GColor color) {
+#if defined(PBL_BW)
+  uint8_t shade = dither_shade(color);
+  graphics_context_set_fill_color(ctx, is_pattern(shade) ? base_color(shade) : dither_solid(color));
+  graphics_fill_rect(ctx, rect, corner_radius, GCornersAll);
+  if (!is_pattern(shade)) {
+    return;
+  }
+  graphics_context_set_stroke_color(ctx, pattern_color(shade));
+  for (int row = 0; row < rect.size.h; row++) {
+    // Cut the corners diagonally, which stays inside the rounded ones.
+    int from_edge = MIN(row, rect.size.h - 1 - row);
+    int inset = MAX(corner_radius - from_edge, 0);
+    draw_pattern_span(ctx, rect.origin.y + row, rect.origin.x + inset,
+                      rect.origin.x + rect.size.w - inset, shade);
+  }
+#else
+  graphics_context_set_fill_color(ctx, color);
+  graphics_fill_rect(ctx, rect, corner_radius, GCornersAll);
+#endif
+}
+#if defined(PBL_BW)
+static int floor_div(int numerator, int denominator) {
+  int quotient = numerator / denominator;
+  return (numerator % denominator != 0 && (numerator < 0) != (denominator < 0)) ? quotient - 1 : quotient;
+}
+// The firmware fills the path in the pattern's base color in one call; the pattern's other pixels
+// are found with an even-odd scanline pass sampled at pixel centers, with crossings kept in
+// sixteenths of a pixel. Where that disagrees with the firmware's fill by a pixel, the outline
+// drawn over the path covers it.
+void dither_fill_path(GContext *ctx, GRect clip, GPath *path, const GPoint *points, int count, GColor color) {
+  uint8_t shade = dither_shade(color);
+  graphics_context_set_fill_color(ctx, is_pattern(shade) ? base_color(shade) : dither_solid(color));
+  gpath_draw_filled(ctx, path);
+  if (!is_pattern(shade)) {
+    return;
+  }
+  graphics_context_set_stroke_color(ctx, pattern_color(shade));
+  int top = INT16_MAX;
+  int bottom = INT16_MIN;
+  for (int i = 0; i < count; i++) {
+    top = MIN(top, points[i].y);
+    bottom = MAX(bottom, points[i].y);
+  }
+  // The firmware would clip these too, but only after one graphics call per pixel.
+  top = MAX(top, clip.origin.y);
+  bottom = MIN(bottom, clip.origin.y + clip.size.h - 1);
+  for (int y = top; y <= bottom; y++) {
+    int center_y = 2 * y + 1;
+    int crossings[DITHER_MAX_CROSSINGS];
+    int crossing_count = 0;
+    for (int i = 0; i < count && crossing_count < DITHER_MAX_CROSSINGS; i++) {
+      GPoint a = points[i];
+      GPoint b = points[(i + 1) % count];
+      if ((2 * a.y <= center_y) != (2 * b.y <= center_y)) {
+        crossings[crossing_count++] = 16 * a.x + floor_div(8 * (center_y - 2 * a.y) * (b.x - a.x), b.y - a.y);
+      }
+    }
+    for (int i = 1; i < crossing_count; i++) {
+      for (int j = i; j > 0 && crossings[j - 1] > crossings[j]; j--) {
+        int swap = crossings[j];
+        crossings[j] = crossings[j - 1];
+        crossings[j - 1] = swap;
+      }
+    }
+    for (int i = 0; i + 1 < crossing_count; i += 2) {
+      // The first and last pixels whose centers lie inside the span.
+      int x0 = MAX(floor_div(crossings[i] - 8 + 15, 16), clip.origin.x);
+      int x1 = MIN(floor_div(crossings[i + 1] - 8 + 15, 16), clip.origin.x + clip.size.w);
+      draw_pattern_span(ctx, y, x0, x1, shade);
+    }
+  }
+}
+#endif
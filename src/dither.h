@@ -0,0 +1,18 @@
+#pragma once
+#include <pebble.h>
+
+// Fills for the 1-bit display. Colors are reduced to one of five shades, from
+// black to white, and the grays in between are drawn as a 2x2 ordered dither.
+// On color platforms the rectangle fill is a plain fill in the given color.
+#define DITHER_SHADES 5
+
+uint8_t dither_shade(GColor color);
+// The nearest color the display can show without a pattern.
+GColor dither_solid(GColor color);
+void dither_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GColor color);
+#if defined(PBL_BW)
+// Fills `path' like gpath_draw_filled(), laying a pattern over it for grays. `points' are the
+// path's points as drawn, in the layer's coordinates; the pattern is only drawn inside `clip',
+// the rectangle the frame repaints.
+void dither_fill_path(GContext *ctx, GRect clip, GPath *path, const GPoint *points, int count, GColor color);
+#endif
@@ -0,0 +1,18 @@
+#include <pebble.h>
+#include "frame_model.h"
+#include "bezel.h"
+
+void frame_model_update(FrameModel *model, const struct tm *tick_time,
+                        const uint8_t *minute_lengths, const uint8_t *hour_lengths) {
+  // The hour hand moves every minute, so its angle is kept in half degrees.
+  int hour_half_degrees = ((tick_time->tm_hour % 12) * 60) + tick_time->tm_min;
+  
+  model->second_angle = TRIG_MAX_ANGLE / 360 * (tick_time->tm_sec * 6);
+  model->minute_angle = TRIG_MAX_ANGLE / 360 * (tick_time->tm_min * 6);
+  model->hour_angle = TRIG_MAX_ANGLE / 720 * hour_half_degrees;
+  
+  // The lengths reach the edge of the screen; see bezel.c. Each hand style keeps its tips some way inside.
+  model->second_length = minute_lengths[tick_time->tm_sec % MINUTE_HAND_STEPS];
+  model->minute_length = minute_lengths[tick_time->tm_min % MINUTE_HAND_STEPS];
+  model->hour_length = hour_lengths[hour_half_degrees % HOUR_HAND_STEPS];
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <pebble.h>
+
+// Where the hands point for one tick, computed once from the tick handler's
+// `struct tm' so all hands render the same instant.
+typedef struct {
+  int32_t second_angle;
+  int32_t minute_angle;
+  int32_t hour_angle;
+  uint8_t second_length;
+  uint8_t minute_length;
+  uint8_t hour_length;
+} FrameModel;
+
+// `minute_lengths' and `hour_lengths' are the bezel tables built by bezel_build_table.
+void frame_model_update(FrameModel *model, const struct tm *tick_time,
+                        const uint8_t *minute_lengths, const uint8_t *hour_lengths);
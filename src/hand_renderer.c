@@ -0,0 +1,137 @@
+#include <pebble.h>
+#include "hand_renderer.h"
+#include "dither.h"
+
+// Room around a hand's points for its one pixel outline and antialiasing.
+#define HAND_BOUNDS_MARGIN 2
+
+// Heap allocations made for hands and frames drawn; the former should stop growing after init().
+static int s_allocation_count;
+static int s_frame_count;
+
+HandRenderer *hand_renderer_create() {
+  HandRenderer *renderer = calloc(1, sizeof(HandRenderer));
+  if (!renderer) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unable to allocate hand renderer.");
+    return NULL;
+  }
+  s_allocation_count++;
+  renderer->hand_info.points = renderer->hand_points;
+  renderer->highlight_info.points = renderer->highlight_points;
+  return renderer;
+}
+static void destroy_paths(HandRenderer *renderer) {
+  if (renderer->hand_path) {
+    gpath_destroy(renderer->hand_path);
+    renderer->hand_path = NULL;
+  }
+  if (renderer->highlight_path) {
+    gpath_destroy(renderer->highlight_path);
+    renderer->highlight_path = NULL;
+  }
+}
+void hand_renderer_destroy(HandRenderer *renderer) {
+  if (!renderer) {
+    return;
+  }
+  destroy_paths(renderer);
+  free(renderer);
+}
+// Only runs when the hand style changes; the paths are then reused for every frame.
+void hand_renderer_set_shape(HandRenderer *renderer, const HandShape *shape) {
+  destroy_paths(renderer);
+  renderer->shape = *shape;
+  renderer->hand_info.num_points = shape->point_count;
+  renderer->highlight_info.num_points = shape->highlight_count;
+  
+  // The paths reference the point buffers above, so later length changes need no re-creation.
+  hand_renderer_set_length(renderer, 0);
+  if (shape->point_count > 0) {
+    renderer->hand_path = gpath_create(&renderer->hand_info);
+    s_allocation_count++;
+  }
+  if (shape->highlight_count > 0) {
+    renderer->highlight_path = gpath_create(&renderer->highlight_info);
+    s_allocation_count++;
+  }
+}
+static GPoint place_point(const HandPoint *point, int length) {
+  return GPoint(point->x, (point->anchor == HAND_ANCHOR_TIP) ? -(length - point->y) : point->y);
+}
+// Places the shape's points for a tip `length' pixels out from the center, less the shape's length offset.
+void hand_renderer_set_length(HandRenderer *renderer, int length) {
+  const HandShape *shape = &renderer->shape;
+  length -= shape->length_offset;
+  for (int i = 0; i < shape->point_count; i++) {
+    renderer->hand_points[i] = place_point(&shape->points[i], length);
+  }
+  for (int i = 0; i < shape->highlight_count; i++) {
+    renderer->highlight_points[i] = place_point(&shape->points[shape->point_count + i], length);
+  }
+}
+// Rotates a placed point about the center the way gpath_rotate_to() does.
+static GPoint rotate_point(GPoint point, int32_t sine, int32_t cosine, GPoint center) {
+  return GPoint((point.x * cosine / TRIG_MAX_RATIO) - (point.y * sine / TRIG_MAX_RATIO) + center.x,
+                (point.y * cosine / TRIG_MAX_RATIO) + (point.x * sine / TRIG_MAX_RATIO) + center.y);
+}
+// The screen area the hand covers when drawn with its tip `length' pixels out at `angle'.
+GRect hand_renderer_get_bounds(const HandRenderer *renderer, int length, GPoint center, int32_t angle) {
+  const HandShape *shape = &renderer->shape;
+  if (shape->point_count == 0) {
+    return GRectZero;
+  }
+  int32_t sine = sin_lookup(angle);
+  int32_t cosine = cos_lookup(angle);
+  length -= shape->length_offset;
+  int min_x = INT16_MAX;
+  int min_y = INT16_MAX;
+  int max_x = INT16_MIN;
+  int max_y = INT16_MIN;
+  for (int i = 0; i < shape->point_count + shape->highlight_count; i++) {
+    GPoint point = rotate_point(place_point(&shape->points[i], length), sine, cosine, center);
+    min_x = MIN(min_x, point.x);
+    min_y = MIN(min_y, point.y);
+    max_x = MAX(max_x, point.x);
+    max_y = MAX(max_y, point.y);
+  }
+  return GRect(min_x - HAND_BOUNDS_MARGIN, min_y - HAND_BOUNDS_MARGIN,
+               max_x - min_x + 1 + 2 * HAND_BOUNDS_MARGIN, max_y - min_y + 1 + 2 * HAND_BOUNDS_MARGIN);
+}
+void hand_renderer_draw(HandRenderer *renderer, GContext *ctx, GRect clip, GPoint center, int32_t angle,
+                        GColor fill_color, GColor outline_color) {
+  if (!renderer->hand_path) {
+    return;
+  }
+  s_frame_count++;
+  gpath_move_to(renderer->hand_path, center);
+  gpath_rotate_to(renderer->hand_path, angle);
+#if defined(PBL_BW)
+  // The firmware can only fill paths in black or white, so gray hands get a pattern drawn over that.
+  int32_t sine = sin_lookup(angle);
+  int32_t cosine = cos_lookup(angle);
+  GPoint points[HAND_MAX_POINTS];
+  for (int i = 0; i < renderer->shape.point_count; i++) {
+    points[i] = rotate_point(renderer->hand_points[i], sine, cosine, center);
+  }
+  dither_fill_path(ctx, clip, renderer->hand_path, points, renderer->shape.point_count, fill_color);
+  graphics_context_set_stroke_color(ctx, dither_solid(outline_color));
+  graphics_context_set_stroke_width(ctx, 1);
+#else
+  graphics_context_set_fill_color(ctx, fill_color);
+  graphics_context_set_stroke_color(ctx, outline_color);
+  graphics_context_set_stroke_width(ctx, 1);
+  gpath_draw_filled(ctx, renderer->hand_path);
+#endif
+  gpath_draw_outline(ctx, renderer->hand_path);
+  if (renderer->highlight_path) {
+    gpath_move_to(renderer->highlight_path, center);
+    gpath_rotate_to(renderer->highlight_path, angle);
+    gpath_draw_outline(ctx, renderer->highlight_path);
+  }
+}
+int hand_renderer_get_allocation_count() {
+  return s_allocation_count;
+}
+int hand_renderer_get_frame_count() {
+  return s_frame_count;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <pebble.h>
+#include "hand_style.h"
+
+// A hand whose paths are created once per shape and then only moved and rotated.
+// It owns copies of its points so hands never overwrite each other's shape.
+typedef struct {
+  HandShape shape;
+  GPoint hand_points[HAND_MAX_POINTS];
+  GPoint highlight_points[HAND_MAX_HIGHLIGHT_POINTS];
+  GPathInfo hand_info;
+  GPathInfo highlight_info;
+  GPath *hand_path;
+  GPath *highlight_path;
+} HandRenderer;
+
+HandRenderer *hand_renderer_create();
+void hand_renderer_destroy(HandRenderer *renderer);
+void hand_renderer_set_shape(HandRenderer *renderer, const HandShape *shape);
+void hand_renderer_set_length(HandRenderer *renderer, int length);
+GRect hand_renderer_get_bounds(const HandRenderer *renderer, int length, GPoint center, int32_t angle);
+// `clip' is the part of the layer, in its own coordinates, that the frame repaints.
+void hand_renderer_draw(HandRenderer *renderer, GContext *ctx, GRect clip, GPoint center, int32_t angle,
+                        GColor fill_color, GColor outline_color);
+int hand_renderer_get_allocation_count();
+int hand_renderer_get_frame_count();
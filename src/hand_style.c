@@ -0,0 +1,83 @@
+#include <pebble.h>
+#include "hand_style.h"
+
+#define HAND_STYLE_FORMAT_VERSION 1
+#define HAND_STYLE_HEADER_SIZE 4
+#define HAND_STYLE_DIRECTORY_ENTRY_SIZE 4
+#define HAND_STYLE_HAND_HEADER_SIZE 3
+#define HAND_STYLE_MAX_RECORD_SIZE \
+  (HAND_STYLE_HANDS * (HAND_STYLE_HAND_HEADER_SIZE + (HAND_MAX_POINTS + HAND_MAX_HIGHLIGHT_POINTS) * sizeof(HandPoint)))
+
+static uint16_t read_uint16(const uint8_t *data) {
+  return data[0] | (data[1] << 8);
+}
+// Unpacks one hand from `record', returning the bytes it took, or 0 if it does not fit.
+static size_t parse_hand(const uint8_t *record, size_t size, HandShape *shape) {
+  if (size < HAND_STYLE_HAND_HEADER_SIZE) {
+    return 0;
+  }
+  shape->point_count = record[0];
+  shape->highlight_count = record[1];
+  shape->length_offset = (int8_t) record[2];
+  size_t points_size = (shape->point_count + shape->highlight_count) * sizeof(HandPoint);
+  if (shape->point_count > HAND_MAX_POINTS || shape->highlight_count > HAND_MAX_HIGHLIGHT_POINTS ||
+      HAND_STYLE_HAND_HEADER_SIZE + points_size > size) {
+    return 0;
+  }
+  memcpy(shape->points, record + HAND_STYLE_HAND_HEADER_SIZE, points_size);
+  return HAND_STYLE_HAND_HEADER_SIZE + points_size;
+}
+// Reads the header of the resource, returning how many styles it holds, or 0 if it is not a hand styles file.
+static uint8_t read_style_count(ResHandle handle) {
+  uint8_t header[HAND_STYLE_HEADER_SIZE];
+  if (resource_load_byte_range(handle, 0, header, sizeof(header)) != sizeof(header) ||
+      header[0] != 'H' || header[1] != 'S' || header[2] != HAND_STYLE_FORMAT_VERSION) {
+    return 0;
+  }
+  return header[3];
+}
+uint8_t hand_style_count() {
+  return read_style_count(resource_get_handle(RESOURCE_ID_hand_styles));
+}
+bool hand_style_load(uint8_t style, HandShape shapes[HAND_STYLE_HANDS]) {
+  time_t start_second;
+  uint16_t start_ms;
+  time_ms(&start_second, &start_ms);
+  ResHandle handle = resource_get_handle(RESOURCE_ID_hand_styles);
+  
+  // The header and this style's directory entry, then its record; the rest of the file is never read.
+  if (style >= read_style_count(handle)) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "No hand style %d.", style);
+    return false;
+  }
+  uint8_t entry[HAND_STYLE_DIRECTORY_ENTRY_SIZE];
+  if (resource_load_byte_range(handle, HAND_STYLE_HEADER_SIZE + style * sizeof(entry), entry, sizeof(entry)) !=
+      sizeof(entry)) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Hand style %d is malformed.", style);
+    return false;
+  }
+  uint16_t record_size = read_uint16(entry + 2);
+  uint8_t record[HAND_STYLE_MAX_RECORD_SIZE];
+  if (record_size > sizeof(record) ||
+      resource_load_byte_range(handle, read_uint16(entry), record, record_size) != record_size) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Hand style %d is too large.", style);
+    return false;
+  }
+  size_t offset = 0;
+  for (int i = 0; i < HAND_STYLE_HANDS; i++) {
+    size_t used = parse_hand(record + offset, record_size - offset, &shapes[i]);
+    if (!used) {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Hand style %d is malformed.", style);
+      return false;
+    }
+    offset += used;
+  }
+  
+  time_t end_second;
+  uint16_t end_ms;
+  time_ms(&end_second, &end_ms);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Loaded hand style %d: %d bytes read in %d ms, %d bytes of shapes.", style,
+          (int) (HAND_STYLE_HEADER_SIZE + sizeof(entry) + record_size),
+          (int) ((end_second - start_second) * 1000 + end_ms - start_ms), (int) (HAND_STYLE_HANDS * sizeof(HandShape)));
+  return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <pebble.h>
+
+// Hand shapes packaged in the hand_styles raw resource; see tools/hand_styles.py
+// for the layout. Only the selected style's record is read.
+#define HAND_STYLE_HOUR 0
+#define HAND_STYLE_MINUTE 1
+#define HAND_STYLE_SECOND 2
+#define HAND_STYLE_HANDS 3
+
+#define HAND_MAX_POINTS 8
+#define HAND_MAX_HIGHLIGHT_POINTS 2
+
+// A CENTER point is placed as given; a TIP point's y is its distance back from the tip.
+#define HAND_ANCHOR_CENTER 0
+#define HAND_ANCHOR_TIP 1
+
+typedef struct __attribute__((__packed__)) {
+  int8_t x;
+  int8_t y;
+  uint8_t anchor;
+} HandPoint;
+
+// The hand's outline points, then its highlight line, if any.
+typedef struct {
+  uint8_t point_count;
+  uint8_t highlight_count;
+  // Pixels the tip stays inside the bezel.
+  int8_t length_offset;
+  HandPoint points[HAND_MAX_POINTS + HAND_MAX_HIGHLIGHT_POINTS];
+} HandShape;
+
+// How many styles the resource holds; 0 if it cannot be read.
+uint8_t hand_style_count();
+// Fills `shapes' with the hour, minute and second hands of `style'; false if the resource has no such style.
+bool hand_style_load(uint8_t style, HandShape shapes[HAND_STYLE_HANDS]);
@@ -1,48 +1,77 @@
 #include <pebble.h>
 #include "main.h"
-#include "hand_paths.h"
+#include "bezel.h"
+#include "hand_renderer.h"
+#include "settings.h"
+#include "background_cache.h"
+#include "battery_monitor.h"
+#include "sweep.h"
+#include "profiler.h"
+#include "frame_model.h"
+#include "schedule.h"
+#include "text_widget.h"
+#include "power_policy.h"
 
-#define tickSetting 0
-#define daySetting 1
-#define batterySetting 2
-#define secondStartSetting 3
-#define secondEndSetting 4
-#define digitalSetting 5
-#define windowColorSetting 6
-#define windowBorderColorSetting 7
-#define windowTextColorSetting 8
-#define lightThemeSetting 9
-#define secondHandColorSetting 10
-#define secondOutlineColorSetting 11
+// Info window positions relative to the screen center, laid out on the 144x168 screen.
+#define day_frame_offset GRect(18,-11,22,25)
+#define digital_time_frame_offset GRect(-32,22,68,24)
+#define battery_bar_offset GRect(-24,-42,48,0)
 
-#define day_frame GRect(90,73,22,25)
-#define digital_time_frame GRect(40,106,68,24)
-#define battery_rect GRect(55,38,41,3)
+// How often, and how far apart, the settings state is sent before the phone is assumed absent.
+#define SETTINGS_STATE_ATTEMPTS 5
+#define SETTINGS_STATE_RETRY_MS 2000
 
 static Layer *root_window_layer;  
 static Layer *second_hand_layer;
 static Layer *minute_hand_layer;
 static Layer *hour_hand_layer;
-static Layer *day_layer;
-static Layer *battery_status_layer;
-static Layer *digital_layer;
-static BitmapLayer *background_layer;
-static TextLayer *digital_numbers_layer;
-static TextLayer *day_number_layer;
+static Layer *background_layer;
 static Window *root_window;
 static GBitmap *clockface_bitmap;
-static GPath *second_hand_path;
-static GPath *minute_hand_path;
-static GPath *hour_hand_path;
-static GPath *hand_highlight_path;
+static TextWidget day_widget;
+static TextWidget digital_time_widget;
+static GRect battery_bar;
+static GRect clockface_frame;
+static GRect screen_bounds;
+static GPoint screen_center;
 
-const int32_t trig_ninety = TRIG_MAX_ANGLE / 4;
-const int32_t trig_one_eighty = TRIG_MAX_ANGLE / 2;
-static int previous_hour;
+// Every layer is clipped to `redraw_region', so a frame only repaints those pixels and the rest of the
+// frame buffer keeps the previous frame. Regions requested before the next frame is drawn add up.
+static GRect redraw_region;
+static bool redraw_pending;
+// Where the second hand was last drawn, which has to be repainted when it moves.
+static GRect second_hand_box;
 
-static GColor infoWindowColor;
-static GColor infoWindowBorderColor;
-static GColor infoWindowTextColor;
+// Distance from the center to the bezel for every second/minute and every half degree of the hour hand.
+static uint8_t minute_hand_lengths[MINUTE_HAND_STEPS];
+static uint8_t hour_hand_lengths[HOUR_HAND_STEPS];
+static HandRenderer *second_hand;
+static HandRenderer *minute_hand;
+static HandRenderer *hour_hand;
+
+// Fires at the next schedule transition; nothing polls the schedule in between.
+static AppTimer *schedule_timer;
+// The unit the tick service is subscribed with, so unchanged intervals are not resubscribed.
+static TimeUnits tick_unit;
+// What the draw procs render, refreshed once per tick.
+static FrameModel frame_model;
+static AppTimer *glance_timer;
+static Settings settings;
+// Whether settings_load() found saved settings, and how often the phone has been told so.
+static bool settings_restored;
+static int settings_state_attempts;
+
+// The clockface resource is a palettized image whose gray levels are the coverage of the marks.
+// Themes are applied by rewriting this palette rather than decoding a different image.
+// The 1-bit image on black and white platforms has white marks and is drawn inverted for the light theme.
+#if defined(PBL_COLOR)
+static GColor clockface_palette[16];
+static uint8_t clockface_coverage[16];
+static int clockface_palette_size;
+#else
+static GCompOp clockface_compositing;
+#endif
+static GColor clockface_background;
 
 static GColor hmHandColor;
 static GColor hmOutlineColor;
@@ -50,11 +79,23 @@ static GColor secondHandColor;
 static GColor secondOutlineColor;
 
 static void deinit() {
+  tick_timer_service_unsubscribe();
+  battery_state_service_unsubscribe();
+  accel_tap_service_unsubscribe();
+  sweep_stop();
+  APP_LOG(APP_LOG_LEVEL_INFO, "Sweep: %d fps cap, %d fps achieved, %d ms per frame.", sweep_get_fps(), sweep_get_achieved_fps(), sweep_get_average_cost_ms());
   layer_destroy(second_hand_layer);
   layer_destroy(minute_hand_layer);
   layer_destroy(hour_hand_layer);
-  bitmap_layer_destroy(background_layer);
+  layer_destroy(background_layer);
   window_destroy(root_window);
+  gbitmap_destroy(clockface_bitmap);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Background cache: %d hits, %d misses.", background_cache_get_hits(), background_cache_get_misses());
+  background_cache_destroy();
+  APP_LOG(APP_LOG_LEVEL_INFO, "Hand allocations: %d over %d hand frames.", hand_renderer_get_allocation_count(), hand_renderer_get_frame_count());
+  hand_renderer_destroy(second_hand);
+  hand_renderer_destroy(minute_hand);
+  hand_renderer_destroy(hour_hand);
   APP_LOG(APP_LOG_LEVEL_INFO, "deinit()");
 }
 static struct tm* get_current_time() {
@@ -62,248 +103,263 @@ static struct tm* get_current_time() {
     struct tm *current_time = localtime(&temp);
   return current_time;
 }
+// What the settings ask for, less whatever the power saving tier has dropped.
+static bool second_hand_enabled() {
+  return settings.tick_enabled && power_policy_get_tier() < POWER_TIER_NO_SECONDS;
+}
+static bool info_windows_enabled() {
+  return power_policy_get_tier() < POWER_TIER_NO_INFO_WINDOWS;
+}
+static bool battery_bar_enabled() {
+  return settings.battery_enabled && power_policy_get_tier() < POWER_TIER_STATIC;
+}
 static void set_tick_update_interval(TimeUnits tickunit) {
+  battery_monitor_set_seconds_active(tickunit == SECOND_UNIT);
+  if (tickunit == tick_unit) {
+    return;
+  }
   tick_timer_service_unsubscribe();
   tick_timer_service_subscribe(tickunit, time_change_handler);
+  tick_unit = tickunit;
+}
+static GRect union_rect(GRect a, GRect b) {
+  int x0 = MIN(a.origin.x, b.origin.x);
+  int y0 = MIN(a.origin.y, b.origin.y);
+  int x1 = MAX(a.origin.x + a.size.w, b.origin.x + b.size.w);
+  int y1 = MAX(a.origin.y + a.size.h, b.origin.y + b.size.h);
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+// Clips all layers to `region' for the next frame. Their bounds are offset by the same amount,
+// so every draw proc keeps drawing in screen coordinates.
+static void add_redraw_region(GRect region) {
+  if (redraw_pending) {
+    region = union_rect(redraw_region, region);
+  }
+  redraw_region = region;
+  redraw_pending = true;
+  Layer *layers[] = { background_layer, hour_hand_layer, minute_hand_layer, second_hand_layer };
+  GRect bounds = GRect(-region.origin.x, -region.origin.y, screen_bounds.size.w, screen_bounds.size.h);
+  for (unsigned int i = 0; i < ARRAY_LENGTH(layers); i++) {
+    layer_set_frame(layers[i], region);
+    layer_set_bounds(layers[i], bounds);
+  }
+}
+static void redraw_everything() {
+  add_redraw_region(screen_bounds);
+}
+// Repaints only where the second hand was and where it is going.
+static void redraw_second_hand() {
+  GRect box = hand_renderer_get_bounds(second_hand, frame_model.second_length, screen_center, frame_model.second_angle);
+  add_redraw_region(union_rect(second_hand_box, box));
+  layer_mark_dirty(second_hand_layer);
+}
+// A sweeping hand can point between seconds; the hour table gives its length to half a degree.
+static void set_sweep_angle(int32_t angle) {
+  frame_model.second_angle = angle;
+  frame_model.second_length = hour_hand_lengths[(angle * HOUR_HAND_STEPS / TRIG_MAX_ANGLE) % HOUR_HAND_STEPS];
+}
+static void sweep_frame_handler(int32_t angle) {
+  set_sweep_angle(angle);
+  redraw_second_hand();
+}
+static void show_second_hand(bool shown) {
+  if (layer_get_hidden(second_hand_layer) == shown) {
+    redraw_everything();
+    layer_set_hidden(second_hand_layer, !shown);
+  }
 }
 static bool determine_second_hand_draw() {
-    time_t temp = time(NULL); 
-    struct tm *current_time = localtime(&temp);
-    int current_hour = current_time->tm_hour;
-    int start_hour = persist_read_int(secondStartSetting);
-    int end_hour = persist_read_int(secondEndSetting);
-    if ((current_hour >= start_hour && current_hour <= end_hour) && persist_read_bool(tickSetting))  {
+    struct tm *current_time = get_current_time();
+    // In glance mode the second hand runs only while the timer started by a wrist flick is pending.
+    bool second_hand_due = (settings.second_mode == SECOND_MODE_GLANCE) ? glance_timer != NULL :
+      schedule_is_active(settings.schedule_windows, settings.schedule_window_count, schedule_minute_of_week(current_time));
+    if (second_hand_due && second_hand_enabled() && sweep_is_available())  {
+      // The sweep loop redraws the second hand itself, so ticks are only needed for the other hands.
+      APP_LOG(APP_LOG_LEVEL_INFO, "Sweeping the second hand at %d fps.", sweep_get_fps());
+      show_second_hand(true);
+      set_tick_update_interval(MINUTE_UNIT);
+      sweep_start(sweep_frame_handler, sweep_stopped_handler);
+      battery_monitor_set_seconds_active(true);
+      return true;
+    } else if (second_hand_due && second_hand_enabled())  {
       APP_LOG(APP_LOG_LEVEL_INFO, "Setting updates to every second.");
-      layer_set_hidden(second_hand_layer, false);
+      show_second_hand(true);
       set_tick_update_interval(SECOND_UNIT);
       return true;
     } else {
       APP_LOG(APP_LOG_LEVEL_INFO, "Setting updates to every minute.");
-      layer_set_hidden(second_hand_layer, true);
+      sweep_stop();
+      show_second_hand(false);
       set_tick_update_interval(MINUTE_UNIT);
       return false;
   }
 }
-static void time_change_handler(struct tm *current_time, TimeUnits units_changed) {
-//  determine_second_hand_draw();
-  APP_LOG(APP_LOG_LEVEL_INFO, "Tick handling.");
-  int current_hour = current_time->tm_hour;
-  if (current_hour != previous_hour) {
-    determine_second_hand_draw();  
-    previous_hour = current_hour;
-    APP_LOG(APP_LOG_LEVEL_INFO, "New hour has elapsed.");
+// Called when the sweep governor gives up; falls back to a ticking second hand.
+static void sweep_stopped_handler() {
+  determine_second_hand_draw();
+}
+static void schedule_timer_callback(void *data) {
+  schedule_timer = NULL;
+  determine_second_hand_draw();
+  arm_schedule_timer();
+}
+// Arms one timer for the next time the schedule turns the second hand on or off.
+static void arm_schedule_timer() {
+  if (schedule_timer) {
+    app_timer_cancel(schedule_timer);
+    schedule_timer = NULL;
   }
-  layer_mark_dirty(root_window_layer);
+  if (!second_hand_enabled() || settings.second_mode != SECOND_MODE_HOURS) {
+    return;
+  }
+  time_t seconds;
+  uint16_t milliseconds;
+  time_ms(&seconds, &milliseconds);
+  struct tm *current_time = localtime(&seconds);
+  int minutes = schedule_minutes_to_transition(settings.schedule_windows, settings.schedule_window_count,
+                                               schedule_minute_of_week(current_time));
+  if (minutes < 0) {
+    return;
+  }
+  uint32_t timeout_ms = ((minutes * 60) - current_time->tm_sec) * 1000 - milliseconds;
+  schedule_timer = app_timer_register(timeout_ms, schedule_timer_callback, NULL);
 }
-static void digital_numbers_layer_draw(Layer *layer, GContext *ctx) {
-    graphics_context_set_fill_color(ctx, infoWindowColor);
-    graphics_context_set_stroke_color(ctx, infoWindowBorderColor);
-    graphics_context_set_stroke_width(ctx, 1);
-    graphics_fill_rect(ctx, digital_time_frame, 5, GCornersAll);
-    graphics_draw_round_rect(ctx, digital_time_frame, 5);
-  
-    static char string_time[16];
-    clock_copy_time_string(string_time, sizeof(string_time));
-    APP_LOG(APP_LOG_LEVEL_INFO, "%s.", string_time);
-    text_layer_set_font(digital_numbers_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_background_color(digital_numbers_layer, GColorClear);
-    text_layer_set_text_color(digital_numbers_layer, infoWindowTextColor);
-    text_layer_set_text_alignment(digital_numbers_layer, GTextAlignmentCenter);
-    text_layer_set_text(digital_numbers_layer, string_time);
+static void glance_timer_callback(void *data) {
+  glance_timer = NULL;
+  determine_second_hand_draw();
 }
-static void second_hand_layer_draw(Layer *layer, GContext *ctx) {
-  determine_hand_colors();
-  // Get the current time.
-  time_t temp = time(NULL); 
-  struct tm *current_time = localtime(&temp);
-  
-  // `second_angle' is the simple angle used to rotate the path
-  // `trig_second_angle' is the value used to calculate the length that the path needs to be.
-  int second_angle = current_time->tm_sec * 6;
-  int trig_second_angle = (TRIG_MAX_ANGLE / 60) * current_time->tm_sec;
-
-  // `center' will be the origin for the path.
-  GRect rect = layer_get_frame(layer);
-  GPoint center = grect_center_point(&rect);
-  
-  // The length of the hand for the left or right edge of the screen for seconds 7-23 and 37-53.
-  if (((current_time->tm_sec >= 7 && current_time->tm_sec <= 23) ||
-       (current_time->tm_sec >= 37 && current_time->tm_sec <= 53)) &&
-      current_time->tm_sec != 0) {
-    float second_length = (72 * TRIG_MAX_ANGLE) / (cos_lookup(trig_second_angle - trig_ninety));
-    second_hand_path_points.points[4].y = (second_length > 0) ? -(second_length) : second_length;
-    second_hand_path_points.points[3].y = (second_length > 0) ? -(second_length-5) : second_length+5;
-    second_hand_path_points.points[5].y = (second_length > 0) ? -(second_length-5) : second_length+5;
-    hand_highlight_path_points.points[1].y = (second_length > 0) ? -(second_length-10) : second_length+10;
-  }
-  // The length of the hand for the top or bottom edge of the screen for seconds 54-59, 0-6, and 24-36.
-  else {
-    float second_length = (84 * TRIG_MAX_ANGLE) / (cos_lookup(trig_second_angle - trig_one_eighty));
-    second_hand_path_points.points[4].y = (second_length > 0) ? -(second_length) : second_length;
-    second_hand_path_points.points[3].y = (second_length > 0) ? -(second_length-5) : second_length+5;
-    second_hand_path_points.points[5].y = (second_length > 0) ? -(second_length-5) : second_length+5;
-    hand_highlight_path_points.points[1].y = (second_length > 0) ? -(second_length-10) : second_length+10;
+// A wrist flick shows the second hand for `glance_duration' seconds, extending any glance in progress.
+static void accel_tap_handler(AccelAxisType axis, int32_t direction) {
+  uint32_t timeout_ms = settings.glance_duration * 1000;
+  if (glance_timer) {
+    app_timer_reschedule(glance_timer, timeout_ms);
+    return;
   }
-  
-  // Create and draw the path with the correct length as modified by the calculations above.
-  second_hand_path = gpath_create(&second_hand_path_points);
-  gpath_move_to(second_hand_path, center);
-  gpath_rotate_to(second_hand_path, TRIG_MAX_ANGLE / 360 * second_angle);
-  graphics_context_set_fill_color(ctx, secondHandColor);
-  graphics_context_set_stroke_color(ctx, secondOutlineColor);
-  graphics_context_set_stroke_width(ctx, 1);
-  gpath_draw_filled(ctx, second_hand_path);
-  gpath_draw_outline(ctx, second_hand_path);
-  hand_highlight_path = gpath_create(&hand_highlight_path_points);
-  gpath_move_to(hand_highlight_path, center);
-  gpath_rotate_to(hand_highlight_path, TRIG_MAX_ANGLE / 360 * second_angle);
-  graphics_context_set_stroke_color(ctx, secondOutlineColor);
-  graphics_context_set_stroke_width(ctx, 1);
-  gpath_draw_outline(ctx, hand_highlight_path);  
-  gpath_destroy(second_hand_path);
-  gpath_destroy(hand_highlight_path);
+  glance_timer = app_timer_register(timeout_ms, glance_timer_callback, NULL);
+  determine_second_hand_draw();
 }
-static void minute_hand_layer_draw(Layer *layer, GContext *ctx) {
-  determine_hand_colors();
-  // Get the current time.
-  time_t temp = time(NULL); 
-  struct tm *current_time = localtime(&temp);
-  
-  //current_time->tm_min = 15;
-  
-  // `minute_angle' is the simple angle used to rotate the path
-  // `trig_minute_angle' is the value used to calculate the length that the path needs to be.
-  int minute_angle = current_time->tm_min * 6;
-  int trig_minute_angle = (TRIG_MAX_ANGLE / 60) * current_time->tm_min;
-
-  // `center' will be the origin for the path.
-  GRect rect = layer_get_frame(layer);
-  GPoint center = grect_center_point(&rect);
-  
-  // The length of the hand for the left or right edge of the screen for minutes 7-23 and 37-53.
-  if (((current_time->tm_min >= 7 && current_time->tm_min <= 23) ||
-       (current_time->tm_min >= 37 && current_time->tm_min <= 53)) &&
-      current_time->tm_min != 0) {
-    float minute_length = (72 * TRIG_MAX_ANGLE) / (cos_lookup(trig_minute_angle - trig_ninety));
-    minute_hand_path_points.points[4].y = (minute_length > 0) ? -(minute_length) : minute_length;
-    minute_hand_path_points.points[3].y = (minute_length > 0) ? -(minute_length-5) : minute_length+5;
-    minute_hand_path_points.points[5].y = (minute_length > 0) ? -(minute_length-5) : minute_length+5;
-    hand_highlight_path_points.points[1].y = (minute_length > 0) ? -(minute_length-10) : minute_length+10;
-  }
-  // The length of the hand for the top or bottom edge of the screen for minutes 54-59, 0-6, and 24-36.
-  else {
-    float minute_length = (84 * TRIG_MAX_ANGLE) / (cos_lookup(trig_minute_angle - trig_one_eighty));
-    minute_hand_path_points.points[4].y = (minute_length > 0) ? -(minute_length) : minute_length;
-    minute_hand_path_points.points[3].y = (minute_length > 0) ? -(minute_length-5) : minute_length+5;
-    minute_hand_path_points.points[5].y = (minute_length > 0) ? -(minute_length-5) : minute_length+5;
-    hand_highlight_path_points.points[1].y = (minute_length > 0) ? -(minute_length-10) : minute_length+10;
+// The accelerometer is only listened to while glance mode is selected.
+static void update_glance_subscription() {
+  accel_tap_service_unsubscribe();
+  if (glance_timer) {
+    app_timer_cancel(glance_timer);
+    glance_timer = NULL;
+  }
+  if (second_hand_enabled() && settings.second_mode == SECOND_MODE_GLANCE) {
+    accel_tap_service_subscribe(accel_tap_handler);
   }
-  
-  // Create and draw the path with the correct length as modified by the calculations above.
-  minute_hand_path = gpath_create(&minute_hand_path_points);
-  gpath_move_to(minute_hand_path, center);
-  gpath_rotate_to(minute_hand_path, TRIG_MAX_ANGLE / 360 * minute_angle);
-  graphics_context_set_fill_color(ctx, hmHandColor);
-  graphics_context_set_stroke_color(ctx, hmOutlineColor);
-  graphics_context_set_stroke_width(ctx, 1);
-  gpath_draw_filled(ctx, minute_hand_path);
-  gpath_draw_outline(ctx, minute_hand_path);
-  hand_highlight_path = gpath_create(&hand_highlight_path_points);
-  gpath_move_to(hand_highlight_path, center);
-  gpath_rotate_to(hand_highlight_path, TRIG_MAX_ANGLE / 360 * minute_angle);
-  graphics_context_set_stroke_color(ctx, hmOutlineColor);
-  graphics_context_set_stroke_width(ctx, 1);
-  gpath_draw_outline(ctx, hand_highlight_path);  
-  gpath_destroy(minute_hand_path);
-  gpath_destroy(hand_highlight_path);
 }
-static void hour_hand_layer_draw(Layer *layer, GContext *ctx) {
-  determine_hand_colors();
-  // Get the current time.
-  time_t temp = time(NULL); 
-  struct tm *current_time = localtime(&temp);
-  
-  if (current_time->tm_hour > 12) {
-    current_time->tm_hour-=12;
+// Throws away the cached background so the next frame re-renders the clockface and info widgets.
+static void invalidate_background() {
+  background_cache_invalidate();
+  redraw_everything();
+  layer_mark_dirty(background_layer);
+}
+// Marks dirty only the layers whose contents depend on the units that changed.
+// The background is left alone unless one of its widgets shows something that changed.
+static void invalidate_layers(TimeUnits units_changed) {
+  if (units_changed & SECOND_UNIT) {
+    redraw_second_hand();
   }
-  
-   //current_time->tm_hour = 4;
- // current_time->tm_min = 0;
-  
-  // `hour_angle' is the simple angle used to rotate the path
-  // `trig_hour_angle' is the value used to calculate the length that the path needs to be.
-  int hour_angle = (current_time->tm_hour * 30) + (current_time->tm_min / 2);
-  int trig_hour_angle = (TRIG_MAX_ANGLE / 360) * hour_angle;
-
-  // `center' will be the origin for the path.
-  GRect rect = layer_get_frame(layer);
-  GPoint center = grect_center_point(&rect);
-  
-  // the number of pixels the hour hand will remain from the window edge
-  int hour_length_offset = 35;
-
-  if (((hour_angle >= 49 && hour_angle <= 139) ||
-       (hour_angle >= 229 && hour_angle <= 311)) &&
-      hour_angle != 0) {
-    float hour_length = (72 * TRIG_MAX_ANGLE) / (cos_lookup(trig_hour_angle - trig_ninety));
-    hour_hand_path_points.points[4].y = (hour_length > 0) ? -(hour_length-hour_length_offset) : hour_length+hour_length_offset;
-    hour_hand_path_points.points[3].y = (hour_length > 0) ? -(hour_length-(hour_length_offset+5)) : hour_length+(hour_length_offset+5);
-    hour_hand_path_points.points[5].y = (hour_length > 0) ? -(hour_length-(hour_length_offset+5)) : hour_length+(hour_length_offset+5);
-    hand_highlight_path_points.points[1].y = (hour_length > 0) ? -(hour_length-(hour_length_offset+10)) : hour_length+(hour_length_offset+10);
-  }
-  else {
-    float hour_length = (84 * TRIG_MAX_ANGLE) / (cos_lookup(trig_hour_angle - trig_one_eighty));
-    hour_hand_path_points.points[4].y = (hour_length > 0) ? -(hour_length-hour_length_offset) : hour_length+hour_length_offset;
-    hour_hand_path_points.points[3].y = (hour_length > 0) ? -(hour_length-(hour_length_offset + 5)) : hour_length+(hour_length_offset + 5);
-    hour_hand_path_points.points[5].y = (hour_length > 0) ? -(hour_length-(hour_length_offset + 5)) : hour_length+(hour_length_offset + 5);
-    hand_highlight_path_points.points[1].y = (hour_length > 0) ? -(hour_length-(hour_length_offset+10)) : hour_length+(hour_length_offset+10);
+  if (units_changed & (MINUTE_UNIT | HOUR_UNIT)) {
+    redraw_everything();
+    layer_mark_dirty(minute_hand_layer);
+    layer_mark_dirty(hour_hand_layer);
+    if (settings.digital_enabled && info_windows_enabled()) {
+      invalidate_background();
+    }
   }
-
-  // Create and draw the path with the correct length as modified by the calculations above.
-  hour_hand_path = gpath_create(&hour_hand_path_points);
-  gpath_move_to(hour_hand_path, center);
-  gpath_rotate_to(hour_hand_path, TRIG_MAX_ANGLE / 360 * hour_angle);
-  graphics_context_set_fill_color(ctx, hmHandColor);
-  graphics_context_set_stroke_color(ctx, hmOutlineColor);
-  graphics_context_set_stroke_width(ctx, 1);
-  gpath_draw_filled(ctx, hour_hand_path);
-  gpath_draw_outline(ctx, hour_hand_path);
-  hand_highlight_path = gpath_create(&hand_highlight_path_points);
-  gpath_move_to(hand_highlight_path, center);
-  gpath_rotate_to(hand_highlight_path, TRIG_MAX_ANGLE / 360 * hour_angle);
-  graphics_context_set_stroke_color(ctx, hmOutlineColor);
-  graphics_context_set_stroke_width(ctx, 1);
-  gpath_draw_outline(ctx, hand_highlight_path);  
-  gpath_destroy(hour_hand_path);
-  gpath_destroy(hand_highlight_path);
-}
-static void day_layer_draw (Layer* layer, GContext* ctx) {
-  if (persist_read_bool(daySetting)) {
-    time_t temp = time(NULL); 
-    struct tm *current_time = localtime(&temp);
-    
-    static char day[] = "--";
-    
-    strftime(day, sizeof(day), "%e", current_time);
-    
-    graphics_context_set_fill_color(ctx, infoWindowColor);
-    graphics_context_set_stroke_color(ctx, infoWindowBorderColor);
-    graphics_context_set_stroke_width(ctx, 1);
-    graphics_fill_rect(ctx, day_frame, 5, GCornersAll);
-    graphics_draw_round_rect(ctx, day_frame, 5);
-    
-    text_layer_set_font(day_number_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_background_color(day_number_layer, GColorClear);
-    text_layer_set_text_color(day_number_layer, infoWindowTextColor);
-    text_layer_set_text_alignment(day_number_layer, GTextAlignmentCenter);
-    text_layer_set_text(day_number_layer, day);
+  if (units_changed & (DAY_UNIT | MONTH_UNIT | YEAR_UNIT)) {
+    if (settings.day_enabled && info_windows_enabled()) {
+      invalidate_background();
+    }
+  }
+}
+// Moves to the power saving tier for the current charge; returns true if it changed.
+static bool update_power_tier() {
+  PowerTier previous = power_policy_get_tier();
+  BatteryChargeState charge_state = battery_monitor_get_state();
+  if (power_policy_update(charge_state, settings.power_thresholds) == previous) {
+    return false;
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "Power saving tier %d at %d%%%s.", power_policy_get_tier(),
+          charge_state.charge_percent, charge_state.is_charging ? ", charging" : "");
+  return true;
+}
+// Only repaints when the bar's 10% step, the charging state or the power saving tier changes.
+static void battery_state_handler(BatteryChargeState charge_state) {
+  bool bar_changed = battery_monitor_update(charge_state);
+  if (update_power_tier()) {
+    update_glance_subscription();
+    determine_second_hand_draw();
+    arm_schedule_timer();
+    invalidate_background();
+  } else {
+    // Charging or a recovered charge can bring back a sweep the governor gave up on.
+    if (sweep_recover()) {
+      determine_second_hand_draw();
+    }
+    if (bar_changed && battery_bar_enabled()) {
+      invalidate_background();
+    }
+  }
+  if (!charge_state.is_charging) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Battery %d%%, draining %d%%/day on second ticks, %d%%/day on minute ticks.",
+            charge_state.charge_percent, battery_monitor_get_drain_rate(true), battery_monitor_get_drain_rate(false));
   }
 }
+static void time_change_handler(struct tm *current_time, TimeUnits units_changed) {
+  profiler_begin(PROFILE_TICK_HANDLER);
+  frame_model_update(&frame_model, current_time, minute_hand_lengths, hour_hand_lengths);
+  if (sweep_is_running()) {
+    set_sweep_angle(sweep_get_angle());
+  }
+  // The widget text can only change when its unit rolls over, never on a second tick.
+  if (units_changed & (MINUTE_UNIT | HOUR_UNIT)) {
+    text_widget_update(&digital_time_widget, current_time);
+    // The governor retries a sweep it gave up on once a minute.
+    if (sweep_recover()) {
+      determine_second_hand_draw();
+    }
+  }
+  if (units_changed & (DAY_UNIT | MONTH_UNIT | YEAR_UNIT)) {
+    text_widget_update(&day_widget, current_time);
+  }
+  invalidate_layers(units_changed);
+  profiler_end(PROFILE_TICK_HANDLER);
+}
+// The part of `layer' the current frame repaints, in the layer's own coordinates.
+static GRect visible_rect(Layer *layer) {
+  GRect frame = layer_get_frame(layer);
+  GRect bounds = layer_get_bounds(layer);
+  return GRect(-bounds.origin.x, -bounds.origin.y, frame.size.w, frame.size.h);
+}
+// The hand layers draw in screen coordinates around `screen_center'; see add_redraw_region().
+static void second_hand_layer_draw(Layer *layer, GContext *ctx) {
+  bool sweeping = sweep_is_running();
+  if (sweeping) {
+    sweep_frame_begin();
+  }
+  hand_renderer_set_length(second_hand, frame_model.second_length);
+  hand_renderer_draw(second_hand, ctx, visible_rect(layer), screen_center, frame_model.second_angle, secondHandColor, secondOutlineColor);
+  second_hand_box = hand_renderer_get_bounds(second_hand, frame_model.second_length, screen_center, frame_model.second_angle);
+  if (sweeping) {
+    sweep_frame_end();
+  }
+}
+static void minute_hand_layer_draw(Layer *layer, GContext *ctx) {
+  hand_renderer_set_length(minute_hand, frame_model.minute_length);
+  hand_renderer_draw(minute_hand, ctx, visible_rect(layer), screen_center, frame_model.minute_angle, hmHandColor, hmOutlineColor);
+}
+static void hour_hand_layer_draw(Layer *layer, GContext *ctx) {
+  hand_renderer_set_length(hour_hand, frame_model.hour_length);
+  hand_renderer_draw(hour_hand, ctx, visible_rect(layer), screen_center, frame_model.hour_angle, hmHandColor, hmOutlineColor);
+}
 static void battery_status_draw (Layer* layer, GContext* ctx) {
-  int battery_bar_origin_x = 48;
-  int battery_bar_destination_x = 96;
-  int battery_bar_origin_y = 42;  
-  BatteryChargeState charge_state = battery_state_service_peek(); 
+  int battery_bar_origin_x = battery_bar.origin.x;
+  int battery_bar_destination_x = battery_bar.origin.x + battery_bar.size.w;
+  int battery_bar_origin_y = battery_bar.origin.y;
+  BatteryChargeState charge_state = battery_monitor_get_state();
   
   int current_charge = charge_state.charge_percent;
   int current_depletion = 100 - current_charge;
@@ -311,200 +367,342 @@ static void battery_status_draw (Layer* layer, GContext* ctx) {
   int charge_destination_x = battery_bar_destination_x - (5 * (current_depletion / 10));
   
   graphics_context_set_stroke_width(ctx, 6);
-  graphics_context_set_stroke_color(ctx, GColorLightGray); 
+  graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(GColorLightGray, GColorWhite)); 
   graphics_draw_line(ctx, GPoint(battery_bar_origin_x, battery_bar_origin_y), GPoint(battery_bar_destination_x, battery_bar_origin_y));
   
   graphics_context_set_stroke_width(ctx, 3);
-  graphics_context_set_stroke_color(ctx, GColorDarkGray); 
+  graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(GColorDarkGray, GColorBlack)); 
   graphics_draw_line(ctx, GPoint(battery_bar_origin_x, battery_bar_origin_y), GPoint(battery_bar_destination_x, battery_bar_origin_y));
-  graphics_context_set_stroke_color(ctx, GColorGreen); 
+  graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(GColorGreen, GColorWhite)); 
   graphics_draw_line(ctx, GPoint(battery_bar_origin_x, battery_bar_origin_y), GPoint(charge_destination_x, battery_bar_origin_y));
 }
+// Draws the clockface and the enabled info widgets, which only change on minute, day, battery or settings events.
 static void background_layer_draw (Layer* layer, GContext* ctx) {
-  graphics_draw_bitmap_in_rect(ctx, clockface_bitmap, layer_get_frame(layer));
+  // The background is always drawn first, so this frame takes in every region requested so far.
+  redraw_pending = false;
+  GRect bounds = screen_bounds;
+  if (background_cache_draw(ctx, bounds)) {
+    return;
+  }
+  // The clockface art is 144x168; larger screens get it centered on the theme's background color.
+  if (!grect_equal(&clockface_frame, &bounds)) {
+    graphics_context_set_fill_color(ctx, clockface_background);
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+  }
+  if (clockface_bitmap) {
+#if defined(PBL_BW)
+    graphics_context_set_compositing_mode(ctx, clockface_compositing);
+    graphics_draw_bitmap_in_rect(ctx, clockface_bitmap, clockface_frame);
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+#else
+    graphics_draw_bitmap_in_rect(ctx, clockface_bitmap, clockface_frame);
+#endif
+  }
+  if (battery_bar_enabled()) {
+    battery_status_draw(layer, ctx);
+  }
+  if (settings.day_enabled && info_windows_enabled()) {
+    text_widget_draw(&day_widget, ctx);
+  }
+  if (settings.digital_enabled && info_windows_enabled()) {
+    text_widget_draw(&digital_time_widget, ctx);
+  }
+  background_cache_store(ctx);
 }
-static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
-   Tuple *tick_setting_tuple = dict_find(iterator, tickSetting);
-    if(tick_setting_tuple && tick_setting_tuple->value->int32 > 0) {
-      persist_write_bool(tickSetting, true);
-    } else {
-      persist_write_bool(tickSetting, false);
+// Copies a boolean setting from the message if present; absent keys keep their current value.
+static void read_bool_setting(DictionaryIterator *iterator, uint32_t key, bool *setting) {
+  Tuple *tuple = dict_find(iterator, key);
+  if (tuple) {
+    *setting = tuple->value->int32 > 0;
   }
-  Tuple *day_setting_tuple = dict_find(iterator, daySetting);
-  if(day_setting_tuple && day_setting_tuple->value->int32 > 0) {
-    persist_write_bool(daySetting, true);
-    layer_set_hidden(day_layer, false);
-    layer_set_hidden(text_layer_get_layer(day_number_layer), false);
-  } else {
-    persist_write_bool(daySetting, false);
-    layer_set_hidden(day_layer, true);
-    layer_set_hidden(text_layer_get_layer(day_number_layer), true);
-  }
-  Tuple *battery_setting_tuple = dict_find(iterator, batterySetting);
-  if(battery_setting_tuple && battery_setting_tuple->value->int32 > 0) {
-    persist_write_bool(batterySetting, true);
-    layer_set_hidden(battery_status_layer, false);
-  } else {
-    persist_write_bool(batterySetting, false);
-    layer_set_hidden(battery_status_layer, true);
-  }
-  Tuple *digital_setting_tuple = dict_find(iterator, digitalSetting);
-  if(digital_setting_tuple && digital_setting_tuple->value->int32 > 0) {
-    persist_write_bool(digitalSetting, true);
-    layer_set_hidden(digital_layer, false);
-    layer_set_hidden(text_layer_get_layer(digital_numbers_layer), false);
-  } else {
-    persist_write_bool(digitalSetting, false);
-    layer_set_hidden(digital_layer, true);
-    layer_set_hidden(text_layer_get_layer(digital_numbers_layer), true);
-  }
-  Tuple *light_theme_setting_tuple = dict_find(iterator, lightThemeSetting);
-  if(light_theme_setting_tuple && light_theme_setting_tuple->value->int32 > 0) {
-    persist_write_bool(lightThemeSetting, true);
-    gbitmap_destroy(clockface_bitmap);
-    clockface_bitmap = gbitmap_create_with_resource(RESOURCE_ID_black_marks);
-  } else {
-    persist_write_bool(lightThemeSetting, false);
-    gbitmap_destroy(clockface_bitmap);
-    clockface_bitmap = gbitmap_create_with_resource(RESOURCE_ID_white_marks);
+}
+// Clamps the value into `min'..`max', so nothing wraps around on the way into a uint8_t.
+static void read_clamped_setting(DictionaryIterator *iterator, uint32_t key, uint8_t *setting, int32_t min, int32_t max) {
+  Tuple *tuple = dict_find(iterator, key);
+  if (tuple) {
+    *setting = MAX(MIN(tuple->value->int32, max), min);
+  }
+}
+static void read_percent_setting(DictionaryIterator *iterator, uint32_t key, uint8_t *setting) {
+  read_clamped_setting(iterator, key, setting, 0, 100);
+}
+static void read_color_setting(DictionaryIterator *iterator, uint32_t key, GColor *setting) {
+  Tuple *tuple = dict_find(iterator, key);
+  if (tuple) {
+    *setting = GColorFromHEX(tuple->value->int32);
+  }
+}
+// Replaces the schedule with the packed windows in the message: a days byte, then the
+// start and end minutes as little endian uint16, for each window.
+static void read_schedule_setting(DictionaryIterator *iterator) {
+  Tuple *tuple = dict_find(iterator, scheduleSetting);
+  if (!tuple || tuple->type != TUPLE_BYTE_ARRAY) {
+    return;
+  }
+  const uint8_t *data = tuple->value->data;
+  uint8_t count = MIN(tuple->length / 5, SCHEDULE_MAX_WINDOWS);
+  memset(settings.schedule_windows, 0, sizeof(settings.schedule_windows));
+  for (int i = 0; i < count; i++, data += 5) {
+    settings.schedule_windows[i] = (ScheduleWindow) {
+      .days = data[0] & SCHEDULE_EVERY_DAY,
+      .start_minute = MIN(data[1] | (data[2] << 8), MINUTES_PER_DAY - 1),
+      .end_minute = MIN(data[3] | (data[4] << 8), MINUTES_PER_DAY),
+    };
   }
+  settings.schedule_window_count = count;
+}
+static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
+  if (profiler_handle_message(iterator)) {
+    return;
+  }
+  Settings previous_settings = settings;
+  read_bool_setting(iterator, tickSetting, &settings.tick_enabled);
+  read_bool_setting(iterator, daySetting, &settings.day_enabled);
+  read_bool_setting(iterator, batterySetting, &settings.battery_enabled);
+  read_bool_setting(iterator, digitalSetting, &settings.digital_enabled);
+  read_bool_setting(iterator, lightThemeSetting, &settings.light_theme);
   Tuple *second_start_tuple = dict_find(iterator, secondStartSetting);
   Tuple *second_end_tuple = dict_find(iterator, secondEndSetting);
   if(second_start_tuple && second_end_tuple) {
-    int second_start = second_start_tuple->value->int32;
-    persist_write_int(secondStartSetting, second_start);
-    int second_end = second_end_tuple->value->int32;
-    persist_write_int(secondEndSetting, second_end);
-  }
-  Tuple *window_color_tuple = dict_find(iterator, windowColorSetting);
-  if (window_color_tuple) {
-    infoWindowColor = GColorFromHEX(window_color_tuple->value->int32);
-    persist_write_int(windowColorSetting, window_color_tuple->value->int32);
-  }
-  Tuple *window_border_color_tuple = dict_find(iterator, windowBorderColorSetting);
- if (window_border_color_tuple) {
-    infoWindowBorderColor = GColorFromHEX(window_border_color_tuple->value->int32);
-    persist_write_int(windowBorderColorSetting, window_border_color_tuple->value->int32);
-  }
-  Tuple *window_text_color_tuple = dict_find(iterator, windowTextColorSetting);
-  if (window_text_color_tuple) {
-    infoWindowTextColor = GColorFromHEX(window_text_color_tuple->value->int32);
-    persist_write_int(windowTextColorSetting, window_text_color_tuple->value->int32);
-  }
-  Tuple *second_hand_color_tuple = dict_find(iterator, secondHandColorSetting);
-  if (window_text_color_tuple) {
-    secondHandColor = GColorFromHEX(second_hand_color_tuple->value->int32);
-    persist_write_int(secondHandColorSetting, second_hand_color_tuple->value->int32);
-  }
-  Tuple *second_outline_color_tuple = dict_find(iterator, secondOutlineColorSetting);
-  if (window_text_color_tuple) {
-    secondOutlineColor = GColorFromHEX(second_outline_color_tuple->value->int32);
-    persist_write_int(secondOutlineColorSetting, second_outline_color_tuple->value->int32);
+    settings.second_start_hour = second_start_tuple->value->int32;
+    settings.second_end_hour = second_end_tuple->value->int32;
+    settings_set_schedule_from_hours(&settings);
+  }
+  read_schedule_setting(iterator);
+  read_color_setting(iterator, windowColorSetting, &settings.window_color);
+  read_color_setting(iterator, windowBorderColorSetting, &settings.window_border_color);
+  read_color_setting(iterator, windowTextColorSetting, &settings.window_text_color);
+  read_color_setting(iterator, secondHandColorSetting, &settings.second_hand_color);
+  read_color_setting(iterator, secondOutlineColorSetting, &settings.second_outline_color);
+  Tuple *second_mode_tuple = dict_find(iterator, secondModeSetting);
+  if (second_mode_tuple) {
+    // An unknown mode would leave the second hand to neither the schedule nor wrist flicks.
+    if (second_mode_tuple->value->int32 >= 0 && second_mode_tuple->value->int32 < SECOND_MODE_COUNT) {
+      settings.second_mode = second_mode_tuple->value->int32;
+    } else {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Ignoring unknown second mode %d.", (int) second_mode_tuple->value->int32);
+    }
+  }
+  read_clamped_setting(iterator, sweepSetting, &settings.sweep_fps, 0, SWEEP_MAX_FPS);
+  // The style count costs a resource read, so it is only looked up when a style arrives.
+  if (dict_find(iterator, handStyleSetting)) {
+    read_clamped_setting(iterator, handStyleSetting, &settings.hand_style, 0, hand_style_count() - 1);
+  }
+  read_percent_setting(iterator, powerSecondsThresholdSetting, &settings.power_thresholds[0]);
+  read_percent_setting(iterator, powerInfoThresholdSetting, &settings.power_thresholds[1]);
+  read_percent_setting(iterator, powerStaticThresholdSetting, &settings.power_thresholds[2]);
+  read_clamped_setting(iterator, glanceDurationSetting, &settings.glance_duration, 1, MAX_GLANCE_DURATION);
+  
+  // Nothing is written, reloaded or redrawn unless a value actually changed.
+  if (memcmp(&previous_settings, &settings, sizeof(Settings)) == 0) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Settings unchanged.");
+    return;
+  }
+  settings_save(&settings);
+  if (settings.light_theme != previous_settings.light_theme) {
+    apply_clockface_theme();
+  }
+  if (settings.hand_style != previous_settings.hand_style) {
+    load_hand_style();
+  }
+  determine_hand_colors();
+  // New thresholds can move the tier without any change in charge.
+  if (update_power_tier() || settings.tick_enabled != previous_settings.tick_enabled ||
+      settings.second_mode != previous_settings.second_mode) {
+    update_glance_subscription();
+  }
+  if (settings.sweep_fps != previous_settings.sweep_fps) {
+    sweep_stop();
+    sweep_set_fps_cap(settings.sweep_fps);
   }
   determine_second_hand_draw();
+  arm_schedule_timer();
+  background_cache_invalidate();
+  redraw_everything();
   layer_mark_dirty(root_window_layer);
 }
 static void inbox_dropped_callback(AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Message dropped!");
 }
+// Tells config.js whether the settings survived, so it drops its record of what this watch
+// acknowledged after a reinstall or a discarded version.
+static void send_settings_state(void *data) {
+  DictionaryIterator *iterator;
+  settings_state_attempts++;
+  if (app_message_outbox_begin(&iterator) != APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unable to send the settings state.");
+    return;
+  }
+  dict_write_uint8(iterator, settingsState, settings_restored ? SETTINGS_VERSION : 0);
+  profiler_write_available(iterator);
+  app_message_outbox_send();
+}
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed!");
+  // At launch the phone's JavaScript is often not running yet.
+  if (dict_find(iterator, settingsState) && settings_state_attempts < SETTINGS_STATE_ATTEMPTS) {
+    app_timer_register(SETTINGS_STATE_RETRY_MS, send_settings_state, NULL);
+  }
 }
 static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
   APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send success!");
 }
+#if defined(PBL_COLOR)
+static uint8_t blend_channel(uint8_t from, uint8_t to, int coverage) {
+  return from + (((to - from) * coverage) / 3);
+}
+// Blends `marks' over `background' in four steps, matching the 2-bit channels of the display.
+static GColor blend_colors(GColor background, GColor marks, int coverage) {
+  GColor color = GColorBlack;
+  color.r = blend_channel(background.r, marks.r, coverage);
+  color.g = blend_channel(background.g, marks.g, coverage);
+  color.b = blend_channel(background.b, marks.b, coverage);
+  return color;
+}
+#endif
+static void load_clockface() {
+  clockface_bitmap = gbitmap_create_with_resource(RESOURCE_ID_clockface_marks);
+  if (!clockface_bitmap) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unable to load the clockface, %d bytes free.", (int) heap_bytes_free());
+    return;
+  }
+#if defined(PBL_COLOR)
+  switch (gbitmap_get_format(clockface_bitmap)) {
+    case GBitmapFormat1BitPalette: clockface_palette_size = 2; break;
+    case GBitmapFormat2BitPalette: clockface_palette_size = 4; break;
+    case GBitmapFormat4BitPalette: clockface_palette_size = 16; break;
+    default: clockface_palette_size = 0; break;
+  }
+  GColor *resource_palette = gbitmap_get_palette(clockface_bitmap);
+  for (int i = 0; i < clockface_palette_size; i++) {
+    clockface_coverage[i] = resource_palette[i].r;
+  }
+#endif
+}
+static void apply_clockface_theme() {
+  GColor background = (settings.light_theme) ? GColorWhite : GColorBlack;
+  clockface_background = background;
+#if defined(PBL_BW)
+  clockface_compositing = (settings.light_theme) ? GCompOpAssignInverted : GCompOpAssign;
+#else
+  GColor marks = (settings.light_theme) ? GColorBlack : GColorWhite;
+  for (int i = 0; i < clockface_palette_size; i++) {
+    clockface_palette[i] = blend_colors(background, marks, clockface_coverage[i]);
+  }
+  if (clockface_palette_size > 0) {
+    gbitmap_set_palette(clockface_bitmap, clockface_palette, false);
+  }
+#endif
+}
+// Derives the colors used by the draw procs from the loaded settings.
 static void determine_hand_colors() {
-  secondHandColor = (persist_exists(secondHandColorSetting)) ? GColorFromHEX(persist_read_int(secondHandColorSetting)) : GColorRed;
-  secondOutlineColor = (persist_exists(secondOutlineColorSetting)) ? GColorFromHEX(persist_read_int(secondOutlineColorSetting)) : GColorRichBrilliantLavender;
-  hmHandColor = (persist_read_bool(lightThemeSetting)) ? GColorLightGray : GColorLightGray;
-  hmOutlineColor = (persist_read_bool(lightThemeSetting)) ? GColorBlack : GColorWhite;
+  text_widgets_set_colors(settings.window_color, settings.window_border_color, settings.window_text_color);
+  secondHandColor = settings.second_hand_color;
+  secondOutlineColor = settings.second_outline_color;
+  hmHandColor = GColorLightGray;
+  hmOutlineColor = (settings.light_theme) ? GColorBlack : GColorWhite;
+}
+PROFILER_WRAP_UPDATE_PROC(background_layer_draw, PROFILE_BACKGROUND)
+PROFILER_WRAP_UPDATE_PROC(hour_hand_layer_draw, PROFILE_HOUR_HAND)
+PROFILER_WRAP_UPDATE_PROC(minute_hand_layer_draw, PROFILE_MINUTE_HAND)
+PROFILER_WRAP_UPDATE_PROC(second_hand_layer_draw, PROFILE_SECOND_HAND)
+
+// Reads just the selected style from the hand_styles resource, falling back to the first one.
+static void load_hand_style() {
+  HandShape shapes[HAND_STYLE_HANDS];
+  if (!hand_style_load(settings.hand_style, shapes) && !hand_style_load(0, shapes)) {
+    return;
+  }
+  hand_renderer_set_shape(hour_hand, &shapes[HAND_STYLE_HOUR]);
+  hand_renderer_set_shape(minute_hand, &shapes[HAND_STYLE_MINUTE]);
+  hand_renderer_set_shape(second_hand, &shapes[HAND_STYLE_SECOND]);
+}
+static GRect offset_from_center(GRect offset, GPoint center) {
+  return GRect(center.x + offset.origin.x, center.y + offset.origin.y, offset.size.w, offset.size.h);
+}
+// Lays out everything that depends on the screen size; runs once, so nothing per frame branches on the platform.
+static void layout_for_bounds(GRect bounds) {
+  GPoint center = grect_center_point(&bounds);
+  text_widget_init(&day_widget, offset_from_center(day_frame_offset, center), "%e");
+  text_widget_init(&digital_time_widget, offset_from_center(digital_time_frame_offset, center),
+                   clock_is_24h_style() ? "%H:%M" : "%I:%M");
+  battery_bar = offset_from_center(battery_bar_offset, center);
+  
+  GSize clockface_size = (clockface_bitmap) ? gbitmap_get_bounds(clockface_bitmap).size : GSizeZero;
+  clockface_frame = GRect(center.x - clockface_size.w / 2, center.y - clockface_size.h / 2,
+                          clockface_size.w, clockface_size.h);
+  
+  bezel_build_table(minute_hand_lengths, MINUTE_HAND_STEPS, bounds);
+  bezel_build_table(hour_hand_lengths, HOUR_HAND_STEPS, bounds);
+}
+// Something else covered the screen, so none of the previous frame can be trusted.
+static void window_appear_handler(Window *window) {
+  redraw_everything();
 }
 static void init() {    
   APP_LOG(APP_LOG_LEVEL_INFO, "init()");
+  settings_restored = settings_load(&settings);
+  determine_hand_colors();
   app_message_register_inbox_received(inbox_received_callback);
   app_message_register_inbox_dropped(inbox_dropped_callback);
   app_message_register_outbox_failed(outbox_failed_callback);
   app_message_register_outbox_sent(outbox_sent_callback);
-  app_message_open(app_message_inbox_size_maximum(), app_message_outbox_size_maximum());
+  // The inbox only has to hold one full settings message; the outbox the settings state or a profile.
+  app_message_open(SETTINGS_MESSAGE_SIZE, MAX(SETTINGS_STATE_MESSAGE_SIZE + PROFILER_AVAILABLE_SIZE, PROFILER_OUTBOX_SIZE));
+  send_settings_state(NULL);
+  
+  second_hand = hand_renderer_create();
+  minute_hand = hand_renderer_create();
+  hour_hand = hand_renderer_create();
+  load_hand_style();
   
   root_window = window_create();
   root_window_layer = window_get_root_layer(root_window);
   GRect bounds = layer_get_bounds(root_window_layer);
+  screen_bounds = bounds;
+  screen_center = grect_center_point(&bounds);
+  second_hand_box = bounds;
+  // Pixels outside the redraw region have to survive from the previous frame.
+  window_set_background_color(root_window, GColorClear);
+  window_set_window_handlers(root_window, (WindowHandlers) {
+    .appear = window_appear_handler,
+  });
   
   second_hand_layer = layer_create(bounds);
-  layer_set_update_proc(second_hand_layer, second_hand_layer_draw);
+  layer_set_update_proc(second_hand_layer, PROFILED(second_hand_layer_draw));
   
   minute_hand_layer = layer_create(bounds);
-  layer_set_update_proc(minute_hand_layer, minute_hand_layer_draw);
+  layer_set_update_proc(minute_hand_layer, PROFILED(minute_hand_layer_draw));
   
   hour_hand_layer = layer_create(bounds);
-  layer_set_update_proc(hour_hand_layer, hour_hand_layer_draw);
-  
-  day_layer = layer_create(bounds);
-  layer_set_update_proc(day_layer, day_layer_draw);
+  layer_set_update_proc(hour_hand_layer, PROFILED(hour_hand_layer_draw));
   
-  day_number_layer = text_layer_create(day_frame);
-  
-  digital_layer = layer_create(bounds);
-  layer_set_update_proc(digital_layer, digital_numbers_layer_draw);
-  
-  digital_numbers_layer = text_layer_create(digital_time_frame);
-  
-  battery_status_layer = layer_create(bounds);
-  layer_set_update_proc(battery_status_layer, battery_status_draw);
-  
-  clockface_bitmap = gbitmap_create_with_resource((persist_read_bool(lightThemeSetting)) ? RESOURCE_ID_black_marks : RESOURCE_ID_white_marks);
+  load_clockface();
+  apply_clockface_theme();
+  layout_for_bounds(bounds);
+  struct tm *current_time = get_current_time();
+  frame_model_update(&frame_model, current_time, minute_hand_lengths, hour_hand_lengths);
+  text_widget_update(&day_widget, current_time);
+  text_widget_update(&digital_time_widget, current_time);
     
-  background_layer = bitmap_layer_create(bounds);
-  layer_set_update_proc(bitmap_layer_get_layer(background_layer), background_layer_draw);
+  // The battery bar, day box and digital box are composited into the cached background.
+  background_layer = layer_create(bounds);
+  layer_set_update_proc(background_layer, PROFILED(background_layer_draw));
     
-  layer_add_child(root_window_layer, bitmap_layer_get_layer(background_layer));
-  
-  layer_add_child(root_window_layer, battery_status_layer);
-  
-  layer_add_child(root_window_layer, day_layer);
-  
-  layer_add_child(root_window_layer, digital_layer);
-  
-  layer_add_child(day_layer, text_layer_get_layer(day_number_layer));
-  layer_add_child(digital_layer, text_layer_get_layer(digital_numbers_layer));
-  
-  if (persist_read_bool(batterySetting)) {
-    layer_set_hidden(battery_status_layer, false);
-  } else {
-    layer_set_hidden(battery_status_layer, true);
-  }
-  if (persist_read_bool(daySetting)) {
-    layer_set_hidden(day_layer, false);
-    layer_set_hidden(text_layer_get_layer(day_number_layer), false);
-  } else {
-    layer_set_hidden(day_layer, true);
-    layer_set_hidden(text_layer_get_layer(day_number_layer), true);
-  }
-  if (persist_read_bool(digitalSetting)) {
-    layer_set_hidden(digital_layer, false);
-    layer_set_hidden(text_layer_get_layer(digital_numbers_layer), false);
-  } else {
-    layer_set_hidden(digital_layer, true);
-    layer_set_hidden(text_layer_get_layer(digital_numbers_layer), true);
-  }
+  layer_add_child(root_window_layer, background_layer);
   
   layer_add_child(root_window_layer, hour_hand_layer);
   layer_add_child(root_window_layer, minute_hand_layer);
   layer_add_child(root_window_layer, second_hand_layer);
   
   window_stack_push(root_window, true);
-  set_tick_update_interval((determine_second_hand_draw()) ? SECOND_UNIT : MINUTE_UNIT);
-  struct tm *current_time = get_current_time();
-  infoWindowColor = (persist_exists(windowColorSetting)) ? GColorFromHEX(persist_read_int(windowColorSetting)) : GColorWhite;
-  infoWindowBorderColor = (persist_exists(windowBorderColorSetting)) ? GColorFromHEX(persist_read_int(windowBorderColorSetting)) : GColorDarkGray;
-  infoWindowTextColor = (persist_exists(windowTextColorSetting)) ? GColorFromHEX(persist_read_int(windowTextColorSetting)) : GColorWhite;
-  
-  secondHandColor = (persist_exists(secondHandColorSetting)) ? GColorFromHEX(persist_read_int(secondHandColorSetting)) : GColorRed;
-  secondOutlineColor = (persist_exists(secondOutlineColorSetting)) ? GColorFromHEX(persist_read_int(secondOutlineColorSetting)) : GColorRichBrilliantLavender;
-  hmHandColor = (persist_read_bool(lightThemeSetting)) ? GColorDarkGray : GColorLightGray;
-  hmOutlineColor = (persist_read_bool(lightThemeSetting)) ? GColorBlack : GColorWhite;
-  previous_hour = current_time->tm_hour;
+  battery_monitor_init();
+  update_power_tier();
+  update_glance_subscription();
+  sweep_set_fps_cap(settings.sweep_fps);
+  determine_second_hand_draw();
+  arm_schedule_timer();
+  battery_state_service_subscribe(battery_state_handler);
 }
 
 int main(void) {  
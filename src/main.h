@@ -1,4 +1,8 @@
 #include <pebble.h>
 static void time_change_handler(struct tm *current_time, TimeUnits units_changed);
 static bool determine_second_hand_draw();
-static void determine_hand_colors();
\ No newline at end of file
+static void determine_hand_colors();
+static void apply_clockface_theme();
+static void sweep_stopped_handler();
+static void arm_schedule_timer();
+static void load_hand_style();
@@ -0,0 +1,43 @@
+#include <pebble.h>
+#include "power_policy.h"
+
+static PowerTier s_tier = POWER_TIER_FULL;
+static int s_transition_count;
+
+// The deepest tier whose threshold the charge is at or below.
+static PowerTier tier_for_charge(int charge_percent, const uint8_t thresholds[POWER_THRESHOLD_COUNT]) {
+  PowerTier tier = POWER_TIER_FULL;
+  for (int i = 0; i < POWER_THRESHOLD_COUNT; i++) {
+    if (thresholds[i] > 0 && charge_percent <= thresholds[i]) {
+      tier = (PowerTier) (i + 1);
+    }
+  }
+  return tier;
+}
+PowerTier power_policy_update(BatteryChargeState charge_state, const uint8_t thresholds[POWER_THRESHOLD_COUNT]) {
+  PowerTier tier = s_tier;
+  if (charge_state.is_charging || charge_state.is_plugged) {
+    tier = POWER_TIER_FULL;
+  } else {
+    PowerTier target = tier_for_charge(charge_state.charge_percent, thresholds);
+    if (target > tier) {
+      tier = target;
+    }
+    // Leaves every tier whose threshold the charge is more than POWER_HYSTERESIS_PERCENT above,
+    // so a large jump in the reading can clear several tiers in one update.
+    while (tier > target && charge_state.charge_percent > thresholds[tier - 1] + POWER_HYSTERESIS_PERCENT) {
+      tier--;
+    }
+  }
+  if (tier != s_tier) {
+    s_transition_count++;
+    s_tier = tier;
+  }
+  return tier;
+}
+PowerTier power_policy_get_tier() {
+  return s_tier;
+}
+int power_policy_get_transition_count() {
+  return s_transition_count;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <pebble.h>
+
+// Steps the watchface down as the battery drains. Each tier drops more of
+// what the settings ask for, and is entered once the charge falls to its
+// threshold. It is only left once the charge is more than POWER_HYSTERESIS_PERCENT
+// above that, so readings wobbling around a threshold do not flip it back and
+// forth: with 10% steps a tier entered at 30% is left at 50%. Charging, or just being plugged in, always restores everything.
+typedef enum {
+  POWER_TIER_FULL,
+  // No second hand; the tick service runs on minutes.
+  POWER_TIER_NO_SECONDS,
+  // Also hides the digital time and day windows.
+  POWER_TIER_NO_INFO_WINDOWS,
+  // A static minute-only face: also hides the battery bar.
+  POWER_TIER_STATIC,
+} PowerTier;
+#define POWER_TIER_COUNT 4
+// One threshold per tier below POWER_TIER_FULL, in percent; 0 turns that tier off.
+#define POWER_THRESHOLD_COUNT (POWER_TIER_COUNT - 1)
+#define POWER_DEFAULT_THRESHOLDS { 30, 20, 10 }
+// The firmware reports the charge in 10% steps, and readings wobble by one.
+#define POWER_HYSTERESIS_PERCENT 10
+
+// The tier for `charge_state', moving from the current one; starts at POWER_TIER_FULL.
+PowerTier power_policy_update(BatteryChargeState charge_state, const uint8_t thresholds[POWER_THRESHOLD_COUNT]);
+PowerTier power_policy_get_tier();
+int power_policy_get_transition_count();
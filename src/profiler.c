@@ -0,0 +1,80 @@
+#include <pebble.h>
+#include "profiler.h"
+
+#if defined(PROFILER_ENABLED)
+
+// Ring buffer of the most recent durations, in milliseconds, for each slot.
+typedef struct {
+  uint16_t samples[PROFILER_SAMPLE_COUNT];
+  uint16_t count;
+  uint16_t next;
+  time_t start_second;
+  uint16_t start_ms;
+} ProfileRing;
+
+static ProfileRing s_rings[PROFILE_SLOT_COUNT];
+
+void profiler_begin(ProfileSlot slot) {
+  time_ms(&s_rings[slot].start_second, &s_rings[slot].start_ms);
+}
+void profiler_end(ProfileSlot slot) {
+  ProfileRing *ring = &s_rings[slot];
+  time_t end_second;
+  uint16_t end_ms;
+  time_ms(&end_second, &end_ms);
+  ring->samples[ring->next] = (end_second - ring->start_second) * 1000 + end_ms - ring->start_ms;
+  ring->next = (ring->next + 1) % PROFILER_SAMPLE_COUNT;
+  ring->count = MIN(ring->count + 1, PROFILER_SAMPLE_COUNT);
+}
+static void write_uint16(uint8_t **cursor, uint16_t value) {
+  (*cursor)[0] = value & 0xff;
+  (*cursor)[1] = value >> 8;
+  *cursor += 2;
+}
+// Appends count, min, avg, max and p95 of one slot; sorting a copy keeps the ring in order.
+static void summarize_slot(const ProfileRing *ring, uint8_t **cursor) {
+  uint16_t sorted[PROFILER_SAMPLE_COUNT];
+  uint32_t total = 0;
+  for (int i = 0; i < ring->count; i++) {
+    uint16_t value = ring->samples[i];
+    int j = i;
+    for (; j > 0 && sorted[j - 1] > value; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+    total += value;
+  }
+  write_uint16(cursor, ring->count);
+  write_uint16(cursor, (ring->count > 0) ? sorted[0] : 0);
+  write_uint16(cursor, (ring->count > 0) ? total / ring->count : 0);
+  write_uint16(cursor, (ring->count > 0) ? sorted[ring->count - 1] : 0);
+  write_uint16(cursor, (ring->count > 0) ? sorted[(ring->count * 95) / 100] : 0);
+}
+static void send_summary() {
+  uint8_t summary[PROFILER_SUMMARY_SIZE];
+  uint8_t *cursor = summary;
+  *cursor++ = PROFILE_SLOT_COUNT;
+  for (int slot = 0; slot < PROFILE_SLOT_COUNT; slot++) {
+    summarize_slot(&s_rings[slot], &cursor);
+  }
+  DictionaryIterator *iterator;
+  if (app_message_outbox_begin(&iterator) != APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Unable to send the frame profile.");
+    return;
+  }
+  dict_write_data(iterator, profileSummaryKey, summary, sizeof(summary));
+  app_message_outbox_send();
+}
+void profiler_write_available(DictionaryIterator *iterator) {
+  dict_write_uint8(iterator, profilerAvailableKey, 1);
+}
+// Answers a profile request from the phone; returns true if the message was one.
+bool profiler_handle_message(DictionaryIterator *iterator) {
+  if (!dict_find(iterator, profileRequestKey)) {
+    return false;
+  }
+  send_summary();
+  return true;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include <pebble.h>
+
+// A frame profiler that is only compiled in when PROFILER_ENABLED is defined
+// (build with VARIABLE_HANDS_PROFILER=1 in the environment). It times each
+// wrapped update proc and the tick handler with time_ms(), and sends a
+// min/avg/max/p95 summary to the phone when asked to.
+
+#define profileRequestKey 15
+#define profileSummaryKey 16
+// Sent with the settings state at launch, so the phone only asks watches that can answer.
+#define profilerAvailableKey 23
+
+typedef enum {
+  PROFILE_BACKGROUND,
+  PROFILE_HOUR_HAND,
+  PROFILE_MINUTE_HAND,
+  PROFILE_SECOND_HAND,
+  PROFILE_TICK_HANDLER,
+  PROFILE_SLOT_COUNT,
+} ProfileSlot;
+
+#if defined(PROFILER_ENABLED)
+
+#define PROFILER_SAMPLE_COUNT 64
+// A count byte, then count, min, avg, max and p95 as little endian uint16 for every slot.
+#define PROFILER_SUMMARY_SIZE (1 + PROFILE_SLOT_COUNT * 5 * sizeof(uint16_t))
+#define PROFILER_OUTBOX_SIZE (1 + 7 + PROFILER_SUMMARY_SIZE)
+#define PROFILER_AVAILABLE_SIZE (7 + sizeof(uint8_t))
+
+void profiler_begin(ProfileSlot slot);
+void profiler_end(ProfileSlot slot);
+bool profiler_handle_message(DictionaryIterator *iterator);
+void profiler_write_available(DictionaryIterator *iterator);
+
+// Defines `proc'_profiled, which times `proc' in `slot'; pass PROFILED(proc) to layer_set_update_proc.
+#define PROFILER_WRAP_UPDATE_PROC(proc, slot) \
+  static void proc##_profiled(Layer *layer, GContext *ctx) { \
+    profiler_begin(slot); \
+    proc(layer, ctx); \
+    profiler_end(slot); \
+  }
+#define PROFILED(proc) proc##_profiled
+
+#else
+
+#define PROFILER_OUTBOX_SIZE 0
+#define PROFILER_AVAILABLE_SIZE 0
+#define profiler_begin(slot)
+#define profiler_end(slot)
+#define profiler_handle_message(iterator) false
+#define profiler_write_available(iterator)
+#define PROFILER_WRAP_UPDATE_PROC(proc, slot)
+#define PROFILED(proc) proc
+
+#endif
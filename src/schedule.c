@@ -0,0 +1,76 @@
+#include <pebble.h>
+#include "schedule.h"
+
+ScheduleWindow schedule_window_from_hours(uint8_t start_hour, uint8_t end_hour) {
+  // An end before the start never matched under the old hour range, so it stays off.
+  if (start_hour > end_hour || end_hour > 23) {
+    return (ScheduleWindow) { .days = 0 };
+  }
+  return (ScheduleWindow) {
+    .days = SCHEDULE_EVERY_DAY,
+    .start_minute = start_hour * 60,
+    .end_minute = (end_hour + 1) * 60,
+  };
+}
+int schedule_minute_of_week(const struct tm *time) {
+  return (time->tm_wday * MINUTES_PER_DAY) + (time->tm_hour * 60) + time->tm_min;
+}
+static int window_length(const ScheduleWindow *window) {
+  int length = window->end_minute - window->start_minute;
+  return (length <= 0) ? length + MINUTES_PER_DAY : length;
+}
+// Minutes from `minute_of_week' forward to `target', which may lie past the end of the week.
+static int minutes_until(int minute_of_week, int target) {
+  return (target - minute_of_week + 2 * MINUTES_PER_WEEK) % MINUTES_PER_WEEK;
+}
+bool schedule_is_active(const ScheduleWindow *windows, uint8_t count, int minute_of_week) {
+  for (int i = 0; i < count; i++) {
+    int length = window_length(&windows[i]);
+    for (int day = 0; day < 7; day++) {
+      if (!(windows[i].days & (1 << day))) {
+        continue;
+      }
+      // How far into this day's window the minute lies, if at all.
+      int into = minutes_until(day * MINUTES_PER_DAY + windows[i].start_minute, minute_of_week);
+      if (into < length) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+// Walks the window edges in order of distance, skipping those where overlapping windows keep the state unchanged.
+int schedule_minutes_to_transition(const ScheduleWindow *windows, uint8_t count, int minute_of_week) {
+  bool active = schedule_is_active(windows, count, minute_of_week);
+  int checked = 0;
+  while (true) {
+    int next = -1;
+    for (int i = 0; i < count; i++) {
+      int start = windows[i].start_minute;
+      int end = start + window_length(&windows[i]);
+      for (int day = 0; day < 7; day++) {
+        if (!(windows[i].days & (1 << day))) {
+          continue;
+        }
+        int edges[] = { day * MINUTES_PER_DAY + start, day * MINUTES_PER_DAY + end };
+        for (int e = 0; e < 2; e++) {
+          // An edge at this very minute has already been applied; it comes round again in a week.
+          int distance = minutes_until(minute_of_week, edges[e]);
+          if (distance == 0) {
+            distance = MINUTES_PER_WEEK;
+          }
+          if (distance > checked && (next < 0 || distance < next)) {
+            next = distance;
+          }
+        }
+      }
+    }
+    if (next < 0) {
+      return -1;
+    }
+    if (schedule_is_active(windows, count, (minute_of_week + next) % MINUTES_PER_WEEK) != active) {
+      return next;
+    }
+    checked = next;
+  }
+}
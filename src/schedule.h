@@ -0,0 +1,26 @@
+#pragma once
+#include <pebble.h>
+
+// Weekly windows during which the second hand runs, to the minute. Instead of
+// polling, callers ask for the distance to the next transition and arm a
+// single timer for it.
+#define SCHEDULE_MAX_WINDOWS 4
+#define SCHEDULE_EVERY_DAY 0x7f
+#define MINUTES_PER_DAY (24 * 60)
+#define MINUTES_PER_WEEK (7 * MINUTES_PER_DAY)
+
+// A window opens at `start_minute' after midnight on each day set in `days'
+// (bit 0 is Sunday) and closes at `end_minute'. An end at or before the start
+// closes the next day, so a window can wrap past midnight.
+typedef struct __attribute__((__packed__)) {
+  uint8_t days;
+  uint16_t start_minute;
+  uint16_t end_minute;
+} ScheduleWindow;
+
+// The window covering the whole hours `start_hour' to `end_hour' inclusive, every day.
+ScheduleWindow schedule_window_from_hours(uint8_t start_hour, uint8_t end_hour);
+int schedule_minute_of_week(const struct tm *time);
+bool schedule_is_active(const ScheduleWindow *windows, uint8_t count, int minute_of_week);
+// Minutes until schedule_is_active next changes, or -1 if it never does.
+int schedule_minutes_to_transition(const ScheduleWindow *windows, uint8_t count, int minute_of_week);
@@ -0,0 +1,71 @@
+#include <pebble.h>
+#include "settings.h"
+
+static void settings_set_defaults(Settings *settings) {
+  *settings = (Settings) {
+    .version = SETTINGS_VERSION,
+    .window_color = GColorWhite,
+    .window_border_color = GColorDarkGray,
+    .window_text_color = GColorWhite,
+    .second_hand_color = GColorRed,
+    .second_outline_color = GColorRichBrilliantLavender,
+    .second_mode = SECOND_MODE_HOURS,
+    .glance_duration = DEFAULT_GLANCE_DURATION,
+    .power_thresholds = POWER_DEFAULT_THRESHOLDS,
+  };
+}
+void settings_set_schedule_from_hours(Settings *settings) {
+  settings->schedule_windows[0] = schedule_window_from_hours(settings->second_start_hour, settings->second_end_hour);
+  settings->schedule_window_count = 1;
+}
+static GColor read_legacy_color(uint32_t key, GColor fallback) {
+  return (persist_exists(key)) ? GColorFromHEX(persist_read_int(key)) : fallback;
+}
+// Builds the settings from the one-key-per-setting layout used before version 1, then drops those keys.
+static void settings_migrate_legacy(Settings *settings) {
+  settings->tick_enabled = persist_read_bool(tickSetting);
+  settings->day_enabled = persist_read_bool(daySetting);
+  settings->battery_enabled = persist_read_bool(batterySetting);
+  settings->second_start_hour = persist_read_int(secondStartSetting);
+  settings->second_end_hour = persist_read_int(secondEndSetting);
+  settings->digital_enabled = persist_read_bool(digitalSetting);
+  settings->window_color = read_legacy_color(windowColorSetting, settings->window_color);
+  settings->window_border_color = read_legacy_color(windowBorderColorSetting, settings->window_border_color);
+  settings->window_text_color = read_legacy_color(windowTextColorSetting, settings->window_text_color);
+  settings->light_theme = persist_read_bool(lightThemeSetting);
+  settings->second_hand_color = read_legacy_color(secondHandColorSetting, settings->second_hand_color);
+  settings->second_outline_color = read_legacy_color(secondOutlineColorSetting, settings->second_outline_color);
+  settings_set_schedule_from_hours(settings);
+  
+  settings_save(settings);
+  for (uint32_t key = tickSetting; key <= secondOutlineColorSetting; key++) {
+    persist_delete(key);
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "Migrated settings to version %d.", SETTINGS_VERSION);
+}
+bool settings_load(Settings *settings) {
+  settings_set_defaults(settings);
+  if (!persist_exists(SETTINGS_PERSIST_KEY)) {
+    settings_migrate_legacy(settings);
+    return false;
+  }
+  // Fields missing from an older, shorter version keep their defaults.
+  Settings stored = *settings;
+  int read = persist_read_data(SETTINGS_PERSIST_KEY, &stored, sizeof(stored));
+  if (read > 0 && stored.version > 0 && stored.version <= SETTINGS_VERSION) {
+    if (stored.version < 4) {
+      settings_set_schedule_from_hours(&stored);
+    }
+    if (stored.second_mode >= SECOND_MODE_COUNT) {
+      stored.second_mode = SECOND_MODE_HOURS;
+    }
+    stored.version = SETTINGS_VERSION;
+    *settings = stored;
+    return true;
+  }
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Discarding settings with unknown version.");
+  return false;
+}
+void settings_save(const Settings *settings) {
+  persist_write_data(SETTINGS_PERSIST_KEY, settings, sizeof(Settings));
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <pebble.h>
+#include "schedule.h"
+#include "power_policy.h"
+
+// AppMessage keys, as declared in appinfo.json. Before settings version 1
+// each of these was also its own persistent storage key.
+#define tickSetting 0
+#define daySetting 1
+#define batterySetting 2
+#define secondStartSetting 3
+#define secondEndSetting 4
+#define digitalSetting 5
+#define windowColorSetting 6
+#define windowBorderColorSetting 7
+#define windowTextColorSetting 8
+#define lightThemeSetting 9
+#define secondHandColorSetting 10
+#define secondOutlineColorSetting 11
+#define secondModeSetting 12
+#define glanceDurationSetting 13
+#define sweepSetting 14
+// Keys 15, 16 and 23 belong to the profiler.
+#define scheduleSetting 17
+#define handStyleSetting 18
+#define powerSecondsThresholdSetting 19
+#define powerInfoThresholdSetting 20
+#define powerStaticThresholdSetting 21
+#define SETTINGS_KEY_COUNT 20
+// Sent by the watch at launch: SETTINGS_VERSION if it restored saved settings, 0 if it is on
+// defaults, so the phone knows whether its record of what the watch acknowledged still holds.
+#define settingsState 22
+
+// Size of a dictionary holding every setting, as computed by dict_calc_buffer_size(): one byte
+// for the count, then a 7 byte header and the value for each tuple. Every value is an int32
+// except the schedule, which is a byte array of up to SCHEDULE_MAX_WINDOWS windows.
+#define SETTINGS_MESSAGE_SIZE (1 + SETTINGS_KEY_COUNT * (7 + sizeof(int32_t)) + \
+                               SCHEDULE_MAX_WINDOWS * sizeof(ScheduleWindow))
+
+// Size of the settingsState message: the count, a tuple header and a uint8.
+#define SETTINGS_STATE_MESSAGE_SIZE (1 + 7 + sizeof(uint8_t))
+
+// Persistent storage key holding the whole Settings struct.
+#define SETTINGS_PERSIST_KEY 100
+#define SETTINGS_VERSION 6
+
+// How the second hand is turned on when tickSetting is set: by the schedule, or by a wrist flick.
+#define SECOND_MODE_HOURS 0
+#define SECOND_MODE_GLANCE 1
+#define SECOND_MODE_COUNT 2
+// Seconds the second hand stays up after a wrist flick; stored in a uint8_t.
+#define DEFAULT_GLANCE_DURATION 10
+#define MAX_GLANCE_DURATION UINT8_MAX
+
+// Every user setting, loaded once at init() and written back in one piece.
+// New fields are only ever appended, so older versions load as a prefix.
+typedef struct __attribute__((__packed__)) {
+  uint8_t version;
+  bool tick_enabled;
+  bool day_enabled;
+  bool battery_enabled;
+  uint8_t second_start_hour;
+  uint8_t second_end_hour;
+  bool digital_enabled;
+  GColor window_color;
+  GColor window_border_color;
+  GColor window_text_color;
+  bool light_theme;
+  GColor second_hand_color;
+  GColor second_outline_color;
+  // Version 2
+  uint8_t second_mode;
+  uint8_t glance_duration;
+  // Version 3
+  uint8_t sweep_fps;
+  // Version 4; replaces second_start_hour and second_end_hour.
+  uint8_t schedule_window_count;
+  ScheduleWindow schedule_windows[SCHEDULE_MAX_WINDOWS];
+  // Version 5; an index into the hand_styles resource.
+  uint8_t hand_style;
+  // Version 6; the charge percent at which each power saving tier starts.
+  uint8_t power_thresholds[POWER_THRESHOLD_COUNT];
+} Settings;
+
+// Returns false when nothing valid was stored and the settings are defaults or legacy values.
+bool settings_load(Settings *settings);
+void settings_save(const Settings *settings);
+// Replaces the schedule with the single daily window given by second_start_hour and second_end_hour.
+void settings_set_schedule_from_hours(Settings *settings);
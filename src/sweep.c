@@ -0,0 +1,171 @@
+#include <pebble.h>
+#include "sweep.h"
+#include "battery_monitor.h"
+
+// Frame rates the governor steps down through, fastest last.
+static const uint8_t s_fps_levels[] = { 4, 10, SWEEP_MAX_FPS };
+#define SWEEP_LEVEL_COUNT ((int) ARRAY_LENGTH(s_fps_levels))
+// Below this charge the governor drops a level every second until it stops sweeping.
+#define SWEEP_LOW_BATTERY_PERCENT 30
+// How long the governor stays at a level it stepped down to before trying the next faster one.
+#define SWEEP_STEP_UP_SECONDS 60
+
+static SweepFrameHandler s_frame_handler;
+static AppTimer *s_timer;
+static SweepStoppedHandler s_stopped_handler;
+// Index into s_fps_levels of the current rate, or -1 once the governor gave up.
+static int s_level = -1;
+// The level the configured cap allows, which the governor climbs back to.
+static int s_cap_level = -1;
+// When s_level last changed, and whether the battery was the reason it went down.
+static time_t s_level_changed;
+static bool s_low_battery;
+
+// Frames and draw time in the current wall clock second, and the result for the previous one.
+static time_t s_window_second;
+static uint16_t s_window_frames;
+static uint32_t s_window_cost_ms;
+static uint8_t s_achieved_fps;
+static uint16_t s_average_cost_ms;
+static time_t s_frame_start_second;
+static uint16_t s_frame_start_ms;
+
+static uint32_t now_ms(time_t *seconds) {
+  uint16_t milliseconds;
+  time_ms(seconds, &milliseconds);
+  return (uint32_t) (*seconds % 60) * 1000 + milliseconds;
+}
+// Picks the fastest level that does not exceed `fps_cap', or turns sweeping off for 0.
+void sweep_set_fps_cap(uint8_t fps_cap) {
+  s_level = -1;
+  for (int i = 0; i < SWEEP_LEVEL_COUNT; i++) {
+    if (fps_cap > 0 && s_fps_levels[i] <= MAX(fps_cap, s_fps_levels[0])) {
+      s_level = i;
+    }
+  }
+  s_cap_level = s_level;
+  s_level_changed = time(NULL);
+  s_low_battery = false;
+}
+bool sweep_is_available() {
+  return s_level >= 0;
+}
+uint8_t sweep_get_fps() {
+  return (s_level >= 0) ? s_fps_levels[s_level] : 0;
+}
+static bool battery_allows_sweep() {
+  BatteryChargeState charge_state = battery_monitor_get_state();
+  return charge_state.is_charging || charge_state.charge_percent > SWEEP_LOW_BATTERY_PERCENT;
+}
+static void governor_set_level(int level, time_t now, const char *reason) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Sweep %s to %d fps: %s.", (level < s_level) ? "down" : "up",
+          (level >= 0) ? s_fps_levels[level] : 0, reason);
+  s_level = level;
+  s_level_changed = now;
+}
+// Goes straight back to the cap once charging starts or the charge recovers, and otherwise
+// tries the next faster level after SWEEP_STEP_UP_SECONDS, as long as the last window's frames
+// were cheap enough for it. Returns true if the level went up.
+static bool governor_step_up(time_t now) {
+  if (s_level >= s_cap_level || !battery_allows_sweep()) {
+    return false;
+  }
+  if (s_low_battery) {
+    s_low_battery = false;
+    governor_set_level(s_cap_level, now, "battery recovered");
+    return true;
+  }
+  if (now - s_level_changed < SWEEP_STEP_UP_SECONDS ||
+      (s_level >= 0 && s_average_cost_ms * 2 > 1000 / s_fps_levels[s_level + 1])) {
+    return false;
+  }
+  governor_set_level(s_level + 1, now, "retrying");
+  return true;
+}
+// Closes the one second measurement window and applies the governor to it.
+static void governor_close_window(time_t now) {
+  s_achieved_fps = s_window_frames;
+  s_average_cost_ms = (s_window_frames > 0) ? s_window_cost_ms / s_window_frames : 0;
+  s_window_frames = 0;
+  s_window_cost_ms = 0;
+  
+  uint16_t frame_period_ms = 1000 / sweep_get_fps();
+  if (!battery_allows_sweep()) {
+    s_low_battery = true;
+    governor_set_level(s_level - 1, now, "low battery");
+  } else if (s_average_cost_ms * 2 > frame_period_ms) {
+    governor_set_level(s_level - 1, now, "frames too expensive");
+  } else {
+    governor_step_up(now);
+  }
+}
+static void sweep_timer_callback(void *data) {
+  s_timer = NULL;
+  time_t seconds;
+  now_ms(&seconds);
+  if (seconds != s_window_second) {
+    s_window_second = seconds;
+    governor_close_window(seconds);
+  }
+  if (!sweep_is_available()) {
+    sweep_stop();
+    if (s_stopped_handler) {
+      s_stopped_handler();
+    }
+    return;
+  }
+  s_frame_handler(sweep_get_angle());
+  s_timer = app_timer_register(1000 / sweep_get_fps(), sweep_timer_callback, NULL);
+}
+void sweep_start(SweepFrameHandler frame_handler, SweepStoppedHandler stopped_handler) {
+  s_frame_handler = frame_handler;
+  s_stopped_handler = stopped_handler;
+  if (s_timer || !sweep_is_available()) {
+    return;
+  }
+  // The first window starts now, not whenever the loop last ran.
+  now_ms(&s_window_second);
+  s_window_frames = 0;
+  s_window_cost_ms = 0;
+  s_timer = app_timer_register(1000 / sweep_get_fps(), sweep_timer_callback, NULL);
+}
+void sweep_stop() {
+  if (s_timer) {
+    app_timer_cancel(s_timer);
+    s_timer = NULL;
+  }
+}
+// While the loop is stopped, lets the governor climb back up; returns true if sweeping became
+// available again, so the caller can restart it.
+bool sweep_recover() {
+  if (s_timer) {
+    return false;
+  }
+  bool was_available = sweep_is_available();
+  return governor_step_up(time(NULL)) && !was_available;
+}
+bool sweep_is_running() {
+  return s_timer != NULL;
+}
+// The second hand's angle right now, to a millisecond.
+int32_t sweep_get_angle() {
+  time_t seconds;
+  return (int32_t) (((int64_t) TRIG_MAX_ANGLE * now_ms(&seconds)) / 60000);
+}
+// Bracket the second hand's draw proc to measure what each frame costs.
+void sweep_frame_begin() {
+  time_ms(&s_frame_start_second, &s_frame_start_ms);
+}
+void sweep_frame_end() {
+  time_t end_second;
+  uint16_t end_ms;
+  time_ms(&end_second, &end_ms);
+  s_window_frames++;
+  s_window_cost_ms += (uint32_t) (end_second - s_frame_start_second) * 1000 + end_ms - s_frame_start_ms;
+}
+uint8_t sweep_get_achieved_fps() {
+  return s_achieved_fps;
+}
+uint16_t sweep_get_average_cost_ms() {
+  return s_average_cost_ms;
+}
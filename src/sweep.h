@@ -0,0 +1,28 @@
+#pragma once
+#include <pebble.h>
+
+// A smoothly sweeping second hand, redrawn from an app_timer loop at up to a
+// configured frame rate. A governor steps the rate down when frames get too
+// expensive or the battery runs low, and gives up on sweeping below the
+// lowest rate. It climbs back to the cap as soon as charging starts or the
+// charge recovers, and otherwise one level a minute while frames are cheap
+// enough.
+// The fastest rate the governor runs at; a higher cap sweeps at this rate.
+#define SWEEP_MAX_FPS 30
+
+typedef void (*SweepFrameHandler)(int32_t angle);
+typedef void (*SweepStoppedHandler)(void);
+
+void sweep_set_fps_cap(uint8_t fps_cap);
+bool sweep_is_available();
+// `frame_handler' gets the second hand's angle for every frame and schedules its redraw.
+void sweep_start(SweepFrameHandler frame_handler, SweepStoppedHandler stopped_handler);
+void sweep_stop();
+bool sweep_recover();
+bool sweep_is_running();
+int32_t sweep_get_angle();
+void sweep_frame_begin();
+void sweep_frame_end();
+uint8_t sweep_get_fps();
+uint8_t sweep_get_achieved_fps();
+uint16_t sweep_get_average_cost_ms();
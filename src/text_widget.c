@@ -0,0 +1,45 @@
+#include <pebble.h>
+#include "text_widget.h"
+#include "dither.h"
+
+static GFont s_font;
+static GColor s_fill_color;
+static GColor s_border_color;
+static GColor s_text_color;
+
+void text_widgets_set_colors(GColor fill_color, GColor border_color, GColor text_color) {
+  s_fill_color = fill_color;
+  s_border_color = dither_solid(border_color);
+  s_text_color = dither_solid(text_color);
+#if defined(PBL_BW)
+  // Text is too thin to read on a pattern, so it takes whichever of black and white the fill is not.
+  if (gcolor_equal(s_text_color, dither_solid(fill_color))) {
+    s_text_color = gcolor_equal(s_text_color, GColorWhite) ? GColorBlack : GColorWhite;
+  }
+#endif
+}
+void text_widget_init(TextWidget *widget, GRect frame, const char *format) {
+  if (!s_font) {
+    s_font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+  }
+  *widget = (TextWidget) {
+    .frame = frame,
+    .format = format,
+  };
+}
+void text_widget_update(TextWidget *widget, const struct tm *time) {
+  strftime(widget->text, sizeof(widget->text), widget->format, time);
+  if (strncmp(widget->format, "%I", 2) == 0 && widget->text[0] == '0') {
+    memmove(widget->text, widget->text + 1, strlen(widget->text));
+  }
+}
+void text_widget_draw(const TextWidget *widget, GContext *ctx) {
+  dither_fill_rect(ctx, widget->frame, 5, s_fill_color);
+  graphics_context_set_stroke_color(ctx, s_border_color);
+  graphics_context_set_stroke_width(ctx, 1);
+  graphics_draw_round_rect(ctx, widget->frame, 5);
+  
+  graphics_context_set_text_color(ctx, s_text_color);
+  graphics_draw_text(ctx, widget->text, s_font, widget->frame,
+                     GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+}
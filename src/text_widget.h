@@ -0,0 +1,17 @@
+#pragma once
+#include <pebble.h>
+
+// The boxed day and digital time windows, drawn straight into the cached
+// background. The font and colors are set up once rather than per draw, and
+// the text is only reformatted when the caller says its unit rolled over.
+typedef struct {
+  GRect frame;
+  const char *format;
+  char text[8];
+} TextWidget;
+
+void text_widgets_set_colors(GColor fill_color, GColor border_color, GColor text_color);
+// `format' is a strftime format; a leading "%I" loses its zero like clock_copy_time_string.
+void text_widget_init(TextWidget *widget, GRect frame, const char *format);
+void text_widget_update(TextWidget *widget, const struct tm *time);
+void text_widget_draw(const TextWidget *widget, GContext *ctx);
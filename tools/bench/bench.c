@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include "bench.h"
+#include "../../src/settings.h"
+
+// Replays a simulated day of ticks through the watchface and prints the
+// counters as JSON lines, one for init() and one per day and per frame.
+
+#define SIMULATED_START 1767225600  // 2026-01-01 00:00:00 UTC
+#define SECONDS_PER_DAY (24 * 60 * 60)
+// In glance mode, the wearer looks at the watch every 10 minutes from 07:00 to 23:00.
+#define GLANCE_INTERVAL (10 * 60)
+#define GLANCE_FIRST_HOUR 7
+#define GLANCE_LAST_HOUR 23
+// Every this many frames the output is checked against a full redraw; prime, so it lands on every second.
+#define VERIFY_INTERVAL 61
+// Frame rate cap for the sweeping second hand mode.
+#define SWEEP_FPS 10
+// In battery mode the charge runs down from 60% to empty by 16:00, is charged back to 40% by 18:00,
+// then drains again. Readings come in 10% steps and wobble by up to 4% every 7 minutes, like a
+// real fuel gauge near a step.
+#define BATTERY_START_PERCENT 60
+#define BATTERY_EMPTY_HOUR 16
+#define BATTERY_UNPLUG_HOUR 18
+#define BATTERY_UNPLUG_PERCENT 40
+#define BATTERY_WOBBLE_PERCENT 4
+#define BATTERY_WOBBLE_MINUTES 7
+
+// In schedule mode the second hand runs over breakfast and from late evening past midnight.
+static const ScheduleWindow s_schedule_windows[] = {
+  { .days = SCHEDULE_EVERY_DAY, .start_minute = 6 * 60 + 30, .end_minute = 8 * 60 + 15 },
+  { .days = SCHEDULE_EVERY_DAY, .start_minute = 22 * 60, .end_minute = 1 * 60 + 30 },
+};
+
+int pebble_app_main(void);
+
+static const char *s_mode;
+static BenchCounters s_init_counters;
+static long s_seconds_in_tier[POWER_TIER_COUNT];
+static int s_battery_events;
+
+static void print_counters(const char *scope, const BenchCounters *counters, double divisor) {
+  const char *format = (divisor == 1.0) ? "%.0f" : "%.3f";
+  printf("{\"mode\": \"%s\", \"scope\": \"%s\"", s_mode, scope);
+#define FIELD(name) do { \
+    printf(", \"" #name "\": "); \
+    printf(format, counters->name / divisor); \
+  } while (0)
+  FIELD(ticks);
+  FIELD(frames);
+  FIELD(layer_redraws);
+  FIELD(gpath_creates);
+  FIELD(gpath_destroys);
+  FIELD(graphics_calls);
+  FIELD(text_draws);
+  FIELD(pixels_touched);
+  FIELD(verified_frames);
+  FIELD(mismatched_pixels);
+  FIELD(bitmap_draws);
+  FIELD(trig_lookups);
+  FIELD(persist_reads);
+  FIELD(persist_writes);
+  FIELD(localtime_calls);
+  FIELD(app_logs);
+  FIELD(heap_allocations);
+  FIELD(heap_bytes_allocated);
+  FIELD(resource_loads);
+  FIELD(font_lookups);
+  FIELD(resource_bytes_read);
+  FIELD(tick_subscribes);
+  FIELD(taps);
+  FIELD(timers_fired);
+  FIELD(messages_sent);
+  FIELD(message_bytes_sent);
+#undef FIELD
+  printf(", \"heap_bytes_live\": %ld, \"heap_bytes_peak\": %ld}\n",
+         counters->heap_bytes_live, counters->heap_bytes_peak);
+}
+// The simulated charge, in hundredths of a percent, `seconds_of_day' into the day.
+static int true_charge(int seconds_of_day, bool *charging) {
+  const int drain = BATTERY_START_PERCENT * 100 / BATTERY_EMPTY_HOUR;
+  int hours_x100 = seconds_of_day / 36;
+  *charging = hours_x100 >= BATTERY_EMPTY_HOUR * 100 && hours_x100 < BATTERY_UNPLUG_HOUR * 100;
+  if (hours_x100 < BATTERY_EMPTY_HOUR * 100) {
+    return BATTERY_START_PERCENT * 100 - drain * hours_x100 / 100;
+  }
+  if (*charging) {
+    int charge_rate = BATTERY_UNPLUG_PERCENT * 100 / (BATTERY_UNPLUG_HOUR - BATTERY_EMPTY_HOUR);
+    return charge_rate * (hours_x100 - BATTERY_EMPTY_HOUR * 100) / 100;
+  }
+  return BATTERY_UNPLUG_PERCENT * 100 - drain * (hours_x100 - BATTERY_UNPLUG_HOUR * 100) / 100;
+}
+// Delivers a battery event whenever the reported 10% step or the charging state changes.
+static void simulate_battery(int seconds_of_day) {
+  bool charging;
+  int charge = true_charge(seconds_of_day, &charging);
+  int wobble = ((seconds_of_day / 60 / BATTERY_WOBBLE_MINUTES) % 2) ? BATTERY_WOBBLE_PERCENT : -BATTERY_WOBBLE_PERCENT;
+  int percent = (charge + wobble * 100 + 500) / 1000 * 10;
+  percent = MAX(MIN(percent, 100), 0);
+  BatteryChargeState state = battery_state_service_peek();
+  if (state.charge_percent == percent && state.is_charging == charging) {
+    return;
+  }
+  PowerTier tier = power_policy_get_tier();
+  s_battery_events++;
+  bench_set_battery(percent, charging);
+  if (power_policy_get_tier() != tier) {
+    printf("{\"mode\": \"%s\", \"scope\": \"tier\", \"time\": \"%02d:%02d\", \"charge_percent\": %d, "
+           "\"charging\": %s, \"tier\": %d}\n", s_mode, seconds_of_day / 3600, seconds_of_day / 60 % 60,
+           percent, charging ? "true" : "false", power_policy_get_tier());
+  }
+}
+static void print_tiers(void) {
+  printf("{\"mode\": \"%s\", \"scope\": \"tiers\", \"battery_events\": %d, \"transitions\": %d, "
+         "\"seconds_in_tier\": [", s_mode, s_battery_events, power_policy_get_transition_count());
+  for (int i = 0; i < POWER_TIER_COUNT; i++) {
+    printf("%s%ld", (i > 0) ? ", " : "", s_seconds_in_tier[i]);
+  }
+  printf("]}\n");
+}
+static void replay_day(void) {
+  bench_render();
+  s_init_counters = bench_counters;
+  print_counters("init", &s_init_counters, 1.0);
+  
+  // Only count steady state from here on; heap live/peak keep their absolute values.
+  BenchCounters day = { .heap_bytes_live = bench_counters.heap_bytes_live, .heap_bytes_peak = bench_counters.heap_bytes_peak };
+  bench_counters = day;
+  for (time_t now = SIMULATED_START + 1; now <= SIMULATED_START + SECONDS_PER_DAY; now++) {
+    bench_advance_to(now);
+    int seconds_of_day = (now - SIMULATED_START) % SECONDS_PER_DAY;
+    if (strcmp(s_mode, "glance") == 0 && seconds_of_day % GLANCE_INTERVAL == 0 &&
+        seconds_of_day >= GLANCE_FIRST_HOUR * 3600 && seconds_of_day < GLANCE_LAST_HOUR * 3600) {
+      bench_tap();
+    }
+    if (strcmp(s_mode, "battery") == 0 && seconds_of_day % 60 == 0) {
+      simulate_battery(now - SIMULATED_START);
+    }
+    s_seconds_in_tier[power_policy_get_tier()]++;
+    bench_render();
+  }
+  print_counters("day", &bench_counters, 1.0);
+  if (bench_counters.frames > 0) {
+    print_counters("frame", &bench_counters, (double) bench_counters.frames);
+  }
+  if (strcmp(s_mode, "battery") == 0) {
+    print_tiers();
+  }
+}
+// Seeds persistent storage the way a configured watch would have it.
+static void seed_settings(bool seconds, bool glance, uint8_t sweep_fps, bool scheduled) {
+  Settings settings = {
+    .version = SETTINGS_VERSION,
+    .tick_enabled = seconds,
+    .day_enabled = true,
+    .battery_enabled = true,
+    .second_start_hour = 0,
+    .second_end_hour = 23,
+    .digital_enabled = true,
+    .window_color = GColorWhite,
+    .window_border_color = GColorDarkGray,
+    .window_text_color = GColorBlack,
+    .second_hand_color = GColorRed,
+    .second_outline_color = GColorRichBrilliantLavender,
+    .second_mode = glance ? SECOND_MODE_GLANCE : SECOND_MODE_HOURS,
+    .glance_duration = DEFAULT_GLANCE_DURATION,
+    .sweep_fps = sweep_fps,
+    .schedule_window_count = 1,
+    .schedule_windows = { schedule_window_from_hours(0, 23) },
+    .power_thresholds = POWER_DEFAULT_THRESHOLDS,
+  };
+  if (scheduled) {
+    settings.schedule_window_count = ARRAY_LENGTH(s_schedule_windows);
+    memcpy(settings.schedule_windows, s_schedule_windows, sizeof(s_schedule_windows));
+  }
+  persist_write_data(SETTINGS_PERSIST_KEY, &settings, sizeof(settings));
+}
+int main(int argc, char **argv) {
+  s_mode = (argc > 1) ? argv[1] : "seconds";
+  bool glance = strcmp(s_mode, "glance") == 0;
+  bool sweep = strcmp(s_mode, "sweep") == 0;
+  bool scheduled = strcmp(s_mode, "schedule") == 0;
+  bool battery = strcmp(s_mode, "battery") == 0;
+  if (strcmp(s_mode, "seconds") != 0 && strcmp(s_mode, "minutes") != 0 && !glance && !sweep && !scheduled && !battery) {
+    fprintf(stderr, "usage: %s [seconds|minutes|glance|sweep|schedule|battery]\n", argv[0]);
+    return 2;
+  }
+  seed_settings(strcmp(s_mode, "seconds") == 0 || glance || sweep || scheduled || battery, glance,
+                sweep ? SWEEP_FPS : 0, scheduled);
+  memset(&bench_counters, 0, sizeof(bench_counters));
+  bench_set_time(SIMULATED_START);
+  if (battery) {
+    bench_set_battery(BATTERY_START_PERCENT, false);
+  }
+  bench_set_verify_interval(VERIFY_INTERVAL);
+  bench_set_event_loop(replay_day);
+  pebble_app_main();
+  return 0;
+}
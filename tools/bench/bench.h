@@ -0,0 +1,53 @@
+#pragma once
+#include "pebble.h"
+
+// Counters kept by the fake SDK in tools/bench/pebble.c.
+typedef struct {
+  long ticks;
+  long frames;
+  long layer_redraws;
+  long gpath_creates;
+  long gpath_destroys;
+  long graphics_calls;
+  long text_draws;
+  long pixels_touched;
+  long verified_frames;
+  long mismatched_pixels;
+  long bitmap_draws;
+  long trig_lookups;
+  long persist_reads;
+  long persist_writes;
+  long localtime_calls;
+  long app_logs;
+  long heap_allocations;
+  long heap_bytes_allocated;
+  long heap_bytes_live;
+  long heap_bytes_peak;
+  long resource_loads;
+  long font_lookups;
+  long resource_bytes_read;
+  long tick_subscribes;
+  long taps;
+  long timers_fired;
+  long messages_sent;
+  long message_bytes_sent;
+} BenchCounters;
+
+extern BenchCounters bench_counters;
+
+// Simulated wall clock, in seconds since the epoch (UTC).
+void bench_set_time(time_t now);
+// Moves the clock forward without firing anything, as if the caller took that long.
+void bench_spend_ms(uint32_t milliseconds);
+// Replaces the body of app_event_loop(); set by the driver.
+void bench_set_event_loop(void (*event_loop)(void));
+// Delivers a tick to the subscribed handler if `now' crossed a subscribed unit.
+void bench_advance_to(time_t now);
+// Runs one compositor pass if any layer was marked dirty.
+void bench_render(void);
+// Every `interval' frames, also redraws the whole screen from scratch and counts the pixels that
+// differ from what the compositor pass left in the frame buffer; 0 turns the check off.
+void bench_set_verify_interval(int interval);
+void bench_set_battery(uint8_t charge_percent, bool is_charging);
+// Delivers a synthetic wrist flick to the accel tap handler, if subscribed.
+void bench_tap(void);
@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+#
+# Builds src/*.c against the fake SDK in tools/bench and replays a simulated
+# day with the second hand off, ticking, shown on wrist flicks and sweeping. Prints one JSON object per line, so
+# the output of two commits can be diffed directly.
+#
+#   python tools/bench/bench.py [--cc gcc] [--out build/host_bench] [--platform aplite] [--profiler] [mode ...]
+#   python tools/bench/bench.py --test [--platform aplite] [--profiler]
+#
+# --platform aplite builds the black and white code paths and packs the frame
+# buffer to 1 bit, so heap_bytes_peak is what the app allocates on aplite.
+#
+# --profiler compiles src/ with PROFILER_ENABLED, like VARIABLE_HANDS_PROFILER=1
+# does on the watch.
+#
+# --test builds the unit tests in tools/bench/test*.c instead, for every
+# platform unless one is given, and fails if any check does. Without a
+# platform it also runs them on basalt with the profiler compiled in.
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.abspath(os.path.join(BENCH_DIR, '..', '..'))
+MODES = ('minutes', 'seconds', 'glance', 'sweep', 'schedule', 'battery')
+PLATFORM_DEFINES = {
+    'basalt': [],
+    'aplite': ['-DBENCH_APLITE'],
+    'chalk': ['-DBENCH_CHALK'],
+    'emery': ['-DBENCH_EMERY'],
+}
+
+
+def build(cc, out_dir, platform='basalt', test=False, profiler=False):
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+    watchface = sorted(glob.glob(os.path.join(ROOT_DIR, 'src', '*.c')))
+    driver = sorted(glob.glob(os.path.join(BENCH_DIR, 'test*.c'))) if test else [os.path.join(BENCH_DIR, 'bench.c')]
+    harness = [os.path.join(BENCH_DIR, 'pebble.c')] + driver
+    objects = []
+    for source in watchface + harness:
+        obj = os.path.join(out_dir, os.path.splitext(os.path.basename(source))[0] + '.o')
+        # The watchface's main() is renamed so the driver can call it, which loses its implicit return.
+        defines = ['-Dmain=pebble_app_main', '-Wno-return-type'] if source in watchface else \
+            ['-DBENCH_RESOURCE_DIR="{}"'.format(os.path.join(ROOT_DIR, 'resources'))]
+        subprocess.check_call([cc, '-std=gnu11', '-O1', '-Wall', '-Wno-unused-function', '-I' + BENCH_DIR] +
+                              PLATFORM_DEFINES[platform] + (['-DPROFILER_ENABLED'] if profiler else []) +
+                              defines + ['-c', source, '-o', obj])
+        objects.append(obj)
+    binary = os.path.join(out_dir, 'test' if test else 'bench')
+    subprocess.check_call([cc, '-o', binary] + objects + ['-lm'])
+    return binary
+
+
+def default_out_dir(platform, profiler=False):
+    name = 'host_bench' if platform == 'basalt' else 'host_bench_' + platform
+    return os.path.join(ROOT_DIR, 'build', name + ('_profiler' if profiler else ''))
+
+
+# `variants' is a list of (platform, profiler) pairs.
+def run_tests(cc, variants, out=None):
+    failed = False
+    for platform, profiler in variants:
+        name = platform + ('_profiler' if profiler else '')
+        binary = build(cc, os.path.join(out, name) if out else default_out_dir(platform, profiler), platform,
+                       test=True, profiler=profiler)
+        sys.stdout.flush()
+        failed |= subprocess.call([binary]) != 0
+    return 1 if failed else 0
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'))
+    parser.add_argument('--out')
+    parser.add_argument('--platform', choices=sorted(PLATFORM_DEFINES))
+    parser.add_argument('--profiler', action='store_true')
+    parser.add_argument('--test', action='store_true')
+    parser.add_argument('modes', nargs='*', default=list(MODES))
+    args = parser.parse_args(argv)
+    if args.test:
+        if args.platform:
+            variants = [(args.platform, args.profiler)]
+        else:
+            variants = [(platform, args.profiler) for platform in sorted(PLATFORM_DEFINES)]
+            if not args.profiler:
+                variants.append(('basalt', True))
+        return run_tests(args.cc, variants, args.out)
+    platform = args.platform or 'basalt'
+    out_dir = args.out or default_out_dir(platform, args.profiler)
+    binary = build(args.cc, out_dir, platform, profiler=args.profiler)
+    for mode in args.modes:
+        sys.stdout.flush()
+        subprocess.check_call([binary, mode])
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,1024 @@
+#include <math.h>
+#include <stdio.h>
+#include "bench.h"
+
+// The fake SDK must call the real allocator and clock.
+#undef malloc
+#undef calloc
+#undef free
+#undef time
+#undef localtime
+
+#if defined(PBL_PLATFORM_CHALK)
+#define SCREEN_WIDTH 180
+#define SCREEN_HEIGHT 180
+#elif defined(PBL_PLATFORM_EMERY)
+#define SCREEN_WIDTH 200
+#define SCREEN_HEIGHT 228
+#else
+#define SCREEN_WIDTH 144
+#define SCREEN_HEIGHT 168
+#endif
+// The clockface art: drawn for the round screen on chalk, and 144x168 everywhere else.
+#if defined(PBL_ROUND)
+#define CLOCKFACE_WIDTH 180
+#define CLOCKFACE_HEIGHT 180
+#else
+#define CLOCKFACE_WIDTH 144
+#define CLOCKFACE_HEIGHT 168
+#endif
+#define MAX_CHILDREN 16
+#define MAX_PERSIST_KEYS 64
+#define MAX_TIMERS 8
+// All of the app's RAM, which on the watch also holds its code and statics.
+#if defined(PBL_PLATFORM_APLITE)
+#define HEAP_SIZE (24 * 1024)
+#elif defined(PBL_PLATFORM_EMERY)
+#define HEAP_SIZE (128 * 1024)
+#else
+#define HEAP_SIZE (64 * 1024)
+#endif
+
+BenchCounters bench_counters;
+
+static time_t s_now;
+static uint64_t s_now_ms;
+static struct tm s_tm;
+static void (*s_event_loop)(void);
+static bool s_dirty;
+static BatteryChargeState s_battery = { .charge_percent = 80 };
+static BatteryStateHandler s_battery_handler;
+static TickHandler s_tick_handler;
+static TimeUnits s_tick_units;
+static AccelTapHandler s_tap_handler;
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  bool hidden;
+  LayerUpdateProc update_proc;
+  Layer *children[MAX_CHILDREN];
+  int child_count;
+};
+struct Window {
+  Layer *root_layer;
+  GColor background_color;
+  WindowHandlers handlers;
+};
+struct GBitmap {
+  GRect bounds;
+  GBitmapFormat format;
+  uint16_t bytes_per_row;
+  uint8_t *data;
+  GColor *palette;
+  bool free_palette;
+};
+struct GPath {
+  GPathInfo info;
+  GPoint offset;
+  int32_t rotation;
+};
+// Drawing goes through `origin', the screen position of the current layer's bounds origin,
+// and is clipped to `clip', the screen area of the layer's frame within its parents'.
+struct GContext {
+  GBitmap *frame_buffer;
+  GColor fill_color;
+  GColor stroke_color;
+  GColor text_color;
+  uint8_t stroke_width;
+  GCompOp compositing_mode;
+  GPoint origin;
+  GRect clip;
+};
+static Window *s_top_window;
+static uint8_t s_pixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static GBitmap s_frame_buffer = {
+  .data = s_pixels,
+  .bounds = {{0, 0}, {SCREEN_WIDTH, SCREEN_HEIGHT}},
+  .format = PBL_IF_ROUND_ELSE(GBitmapFormat8BitCircular, GBitmapFormat8Bit),
+  .bytes_per_row = SCREEN_WIDTH,
+};
+static GContext s_context = { .frame_buffer = &s_frame_buffer };
+static int s_verify_interval;
+// Set while redrawing the reference frame, which ignores layer frames when clipping.
+static bool s_unclipped;
+
+// Heap
+
+typedef struct {
+  size_t size;
+  max_align_t align;
+} HeapHeader;
+
+void *bench_malloc(size_t size) {
+  HeapHeader *header = malloc(sizeof(HeapHeader) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->size = size;
+  bench_counters.heap_allocations++;
+  bench_counters.heap_bytes_allocated += size;
+  bench_counters.heap_bytes_live += size;
+  if (bench_counters.heap_bytes_live > bench_counters.heap_bytes_peak) {
+    bench_counters.heap_bytes_peak = bench_counters.heap_bytes_live;
+  }
+  return header + 1;
+}
+void *bench_calloc(size_t count, size_t size) {
+  void *ptr = bench_malloc(count * size);
+  if (ptr) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+void bench_free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  HeapHeader *header = ((HeapHeader *) ptr) - 1;
+  bench_counters.heap_bytes_live -= header->size;
+  free(header);
+}
+size_t heap_bytes_used(void) {
+  return bench_counters.heap_bytes_live;
+}
+size_t heap_bytes_free(void) {
+  return HEAP_SIZE - bench_counters.heap_bytes_live;
+}
+
+// Time
+
+void bench_set_time(time_t now) {
+  s_now = now;
+  s_now_ms = (uint64_t) now * 1000;
+}
+void bench_spend_ms(uint32_t milliseconds) {
+  s_now_ms += milliseconds;
+  s_now = s_now_ms / 1000;
+}
+time_t bench_time(time_t *tloc) {
+  if (tloc) {
+    *tloc = s_now;
+  }
+  return s_now;
+}
+uint16_t time_ms(time_t *t_utc, uint16_t *out_ms) {
+  uint16_t milliseconds = s_now_ms % 1000;
+  if (t_utc) {
+    *t_utc = (time_t) (s_now_ms / 1000);
+  }
+  if (out_ms) {
+    *out_ms = milliseconds;
+  }
+  return milliseconds;
+}
+struct tm *bench_localtime(const time_t *timep) {
+  bench_counters.localtime_calls++;
+  gmtime_r(timep, &s_tm);
+  return &s_tm;
+}
+size_t clock_copy_time_string(char *buffer, uint8_t size) {
+  struct tm tick_time;
+  gmtime_r(&s_now, &tick_time);
+  return strftime(buffer, size, "%H:%M", &tick_time);
+}
+bool clock_is_24h_style(void) {
+  return true;
+}
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  bench_counters.tick_subscribes++;
+  s_tick_units = tick_units;
+  s_tick_handler = handler;
+}
+void tick_timer_service_unsubscribe(void) {
+  s_tick_handler = NULL;
+}
+// Timers run on the simulated clock, in milliseconds.
+
+struct AppTimer {
+  bool used;
+  uint64_t due_ms;
+  AppTimerCallback callback;
+  void *data;
+};
+static AppTimer s_timers[MAX_TIMERS];
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    if (!s_timers[i].used) {
+      s_timers[i] = (AppTimer) { true, s_now_ms + timeout_ms, callback, callback_data };
+      return &s_timers[i];
+    }
+  }
+  return NULL;
+}
+bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms) {
+  if (!timer_handle || !timer_handle->used) {
+    return false;
+  }
+  timer_handle->due_ms = s_now_ms + new_timeout_ms;
+  return true;
+}
+void app_timer_cancel(AppTimer *timer_handle) {
+  if (timer_handle) {
+    timer_handle->used = false;
+  }
+}
+// Fires timers in due order up to `until_ms', rendering after each like the event loop would.
+static void run_timers(uint64_t until_ms) {
+  for (;;) {
+    AppTimer *next = NULL;
+    for (int i = 0; i < MAX_TIMERS; i++) {
+      if (s_timers[i].used && s_timers[i].due_ms <= until_ms && (!next || s_timers[i].due_ms < next->due_ms)) {
+        next = &s_timers[i];
+      }
+    }
+    if (!next) {
+      break;
+    }
+    s_now_ms = next->due_ms;
+    s_now = s_now_ms / 1000;
+    next->used = false;
+    bench_counters.timers_fired++;
+    next->callback(next->data);
+    bench_render();
+  }
+  s_now_ms = until_ms;
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) {
+  s_tap_handler = handler;
+}
+void accel_tap_service_unsubscribe(void) {
+  s_tap_handler = NULL;
+}
+void bench_tap(void) {
+  bench_counters.taps++;
+  if (s_tap_handler) {
+    s_tap_handler(ACCEL_AXIS_Z, 1);
+  }
+}
+
+void bench_advance_to(time_t now) {
+  struct tm previous;
+  struct tm current;
+  gmtime_r(&s_now, &previous);
+  run_timers((uint64_t) now * 1000);
+  gmtime_r(&now, &current);
+  s_now = now;
+  TimeUnits units_changed = SECOND_UNIT;
+  if (current.tm_min != previous.tm_min) units_changed |= MINUTE_UNIT;
+  if (current.tm_hour != previous.tm_hour) units_changed |= HOUR_UNIT;
+  if (current.tm_mday != previous.tm_mday) units_changed |= DAY_UNIT;
+  if (current.tm_mon != previous.tm_mon) units_changed |= MONTH_UNIT;
+  if (current.tm_year != previous.tm_year) units_changed |= YEAR_UNIT;
+  // A subscription to a unit fires whenever that unit or a larger one changes.
+  if (s_tick_handler && (units_changed & s_tick_units)) {
+    bench_counters.ticks++;
+    s_tick_handler(&current, units_changed);
+  }
+}
+
+// Battery
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+void battery_state_service_unsubscribe(void) {
+  s_battery_handler = NULL;
+}
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery;
+}
+void bench_set_battery(uint8_t charge_percent, bool is_charging) {
+  s_battery.charge_percent = charge_percent;
+  s_battery.is_charging = is_charging;
+  s_battery.is_plugged = is_charging;
+  if (s_battery_handler) {
+    s_battery_handler(s_battery);
+  }
+}
+
+// Logging
+
+void bench_app_log(uint8_t level, const char *fmt, ...) {
+  bench_counters.app_logs++;
+  if (getenv("BENCH_VERBOSE")) {
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+  }
+}
+
+// Geometry and trigonometry
+
+GPoint grect_center_point(const GRect *rect) {
+  return GPoint(rect->origin.x + rect->size.w / 2, rect->origin.y + rect->size.h / 2);
+}
+bool grect_equal(const GRect *rect_a, const GRect *rect_b) {
+  return memcmp(rect_a, rect_b, sizeof(GRect)) == 0;
+}
+bool grect_contains_point(const GRect *rect, const GPoint *point) {
+  return point->x >= rect->origin.x && point->x < rect->origin.x + rect->size.w &&
+         point->y >= rect->origin.y && point->y < rect->origin.y + rect->size.h;
+}
+bool gpoint_equal(const GPoint *point_a, const GPoint *point_b) {
+  return point_a->x == point_b->x && point_a->y == point_b->y;
+}
+bool gcolor_equal(GColor8 x, GColor8 y) {
+  return x.argb == y.argb;
+}
+int32_t sin_lookup(int32_t angle) {
+  bench_counters.trig_lookups++;
+  return (int32_t) lround(sin(2 * M_PI * angle / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+int32_t cos_lookup(int32_t angle) {
+  bench_counters.trig_lookups++;
+  return (int32_t) lround(cos(2 * M_PI * angle / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+// Bitmaps and resources
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = bench_calloc(1, sizeof(GBitmap));
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  bitmap->format = format;
+  switch (format) {
+    // Circular rows are stored at full width here; only their visible span is meaningful.
+    case GBitmapFormat8Bit: case GBitmapFormat8BitCircular: bitmap->bytes_per_row = size.w; break;
+    case GBitmapFormat2BitPalette: bitmap->bytes_per_row = (size.w + 3) / 4; break;
+    case GBitmapFormat4BitPalette: bitmap->bytes_per_row = (size.w + 1) / 2; break;
+    // Like the firmware's, 1-bit rows are padded to whole words.
+    case GBitmapFormat1Bit: bitmap->bytes_per_row = (size.w + 31) / 32 * 4; break;
+    default: bitmap->bytes_per_row = (size.w + 7) / 8; break;
+  }
+  bitmap->data = bench_calloc(bitmap->bytes_per_row, size.h);
+  return bitmap;
+}
+// Every bitmap resource is the clockface art, a 2-bit gray palettized image, or 1-bit on aplite.
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  bench_counters.resource_loads++;
+#if defined(BENCH_APLITE)
+  return gbitmap_create_blank(GSize(CLOCKFACE_WIDTH, CLOCKFACE_HEIGHT), GBitmapFormat1Bit);
+#endif
+  GBitmap *bitmap = gbitmap_create_blank(GSize(CLOCKFACE_WIDTH, CLOCKFACE_HEIGHT), GBitmapFormat2BitPalette);
+  bitmap->palette = bench_calloc(4, sizeof(GColor));
+  bitmap->free_palette = true;
+  for (int i = 0; i < 4; i++) {
+    bitmap->palette[i].argb = 0xC0 | (i << 4) | (i << 2) | i;
+  }
+  return bitmap;
+}
+// Raw resources are read from the files under resources/, which bench.py passes in as BENCH_RESOURCE_DIR.
+static const char *raw_resource_file(uint32_t resource_id) {
+  switch (resource_id) {
+    case RESOURCE_ID_hand_styles: return BENCH_RESOURCE_DIR "/data/hand_styles.bin";
+    default: return NULL;
+  }
+}
+ResHandle resource_get_handle(uint32_t resource_id) {
+  return (ResHandle) (uintptr_t) resource_id;
+}
+size_t resource_size(ResHandle handle) {
+  FILE *file = fopen(raw_resource_file((uintptr_t) handle), "rb");
+  if (!file) {
+    return 0;
+  }
+  fseek(file, 0, SEEK_END);
+  size_t size = ftell(file);
+  fclose(file);
+  return size;
+}
+size_t resource_load_byte_range(ResHandle handle, uint32_t start_offset, uint8_t *buffer, size_t num_bytes) {
+  FILE *file = fopen(raw_resource_file((uintptr_t) handle), "rb");
+  if (!file) {
+    return 0;
+  }
+  bench_counters.resource_loads++;
+  fseek(file, start_offset, SEEK_SET);
+  size_t read = fread(buffer, 1, num_bytes, file);
+  bench_counters.resource_bytes_read += read;
+  fclose(file);
+  return read;
+}
+GColor *gbitmap_get_palette(const GBitmap *bitmap) {
+  return bitmap->palette;
+}
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy) {
+  if (bitmap->free_palette && bitmap->palette != palette) {
+    bench_free(bitmap->palette);
+  }
+  bitmap->palette = palette;
+  bitmap->free_palette = free_on_destroy;
+}
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap) {
+    if (bitmap->free_palette) {
+      bench_free(bitmap->palette);
+    }
+    bench_free(bitmap->data);
+    bench_free(bitmap);
+  }
+}
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->data;
+}
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->bytes_per_row;
+}
+// On round displays a row shows the pixels whose centers lie inside the inscribed circle.
+static void visible_span(const GBitmap *bitmap, int y, int16_t *min_x, int16_t *max_x) {
+  int width = bitmap->bounds.size.w;
+  *min_x = 0;
+  *max_x = width - 1;
+  if (bitmap->format != GBitmapFormat8BitCircular) {
+    return;
+  }
+  int diameter = MIN(width, bitmap->bounds.size.h);
+  int dy = 2 * y + 1 - bitmap->bounds.size.h;
+  while (*min_x <= *max_x) {
+    int dx = 2 * *min_x + 1 - width;
+    if (dx * dx + dy * dy <= diameter * diameter) {
+      break;
+    }
+    (*min_x)++;
+    (*max_x)--;
+  }
+}
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+  GBitmapDataRowInfo info = { .data = bitmap->data + y * bitmap->bytes_per_row };
+  visible_span(bitmap, y, &info.min_x, &info.max_x);
+  return info;
+}
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+  return bitmap->format;
+}
+
+// Graphics
+//
+// A small rasterizer into an 8-bit frame buffer. It does not match the firmware's
+// output pixel for pixel, but it is deterministic and honors layer clipping, which
+// is what pixel counts and redraw checks need. On aplite every pixel is stored as
+// black or white, and the frame buffer handed to the app is packed to 1 bit.
+
+static struct GFont_ { int unused; } s_font;
+GFont fonts_get_system_font(const char *font_key) {
+  bench_counters.font_lookups++;
+  return &s_font;
+}
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  bench_counters.graphics_calls++;
+  ctx->fill_color = color;
+}
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+  bench_counters.graphics_calls++;
+  ctx->stroke_color = color;
+}
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+  bench_counters.graphics_calls++;
+  ctx->text_color = color;
+}
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+  bench_counters.graphics_calls++;
+  ctx->compositing_mode = mode;
+}
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) {
+  bench_counters.graphics_calls++;
+  ctx->stroke_width = stroke_width;
+}
+static GRect intersect_rect(GRect a, GRect b) {
+  int x0 = MAX(a.origin.x, b.origin.x);
+  int y0 = MAX(a.origin.y, b.origin.y);
+  int x1 = MIN(a.origin.x + a.size.w, b.origin.x + b.size.w);
+  int y1 = MIN(a.origin.y + a.size.h, b.origin.y + b.size.h);
+  return GRect(x0, y0, MAX(x1 - x0, 0), MAX(y1 - y0, 0));
+}
+// The screen pixels of `rect', given in the current layer's coordinates, that may be drawn.
+static GRect clip_rect(GContext *ctx, GRect rect) {
+  rect.origin.x += ctx->origin.x;
+  rect.origin.y += ctx->origin.y;
+  return intersect_rect(rect, ctx->clip);
+}
+// What the display shows for `color'; aplite rounds it to black or white.
+static uint8_t screen_color(GColor color) {
+#if defined(BENCH_APLITE)
+  return (color.r + color.g + color.b >= 5) ? GColorWhite.argb : GColorBlack.argb;
+#else
+  return color.argb;
+#endif
+}
+static void put_screen_pixel(int x, int y, GColor color) {
+  s_pixels[y * SCREEN_WIDTH + x] = screen_color(color);
+  bench_counters.pixels_touched++;
+}
+static void put_pixel(GContext *ctx, int x, int y, GColor color) {
+  GRect pixel = clip_rect(ctx, GRect(x, y, 1, 1));
+  if (pixel.size.w > 0 && pixel.size.h > 0) {
+    put_screen_pixel(pixel.origin.x, pixel.origin.y, color);
+  }
+}
+static void fill_rect_with(GContext *ctx, GRect rect, GColor color) {
+  GRect area = clip_rect(ctx, rect);
+  for (int y = area.origin.y; y < area.origin.y + area.size.h; y++) {
+    memset(&s_pixels[y * SCREEN_WIDTH + area.origin.x], screen_color(color), area.size.w);
+  }
+  bench_counters.pixels_touched += area.size.w * area.size.h;
+}
+// A line `ctx->stroke_width' pixels wide, drawn as a square brush moved along it.
+static void stroke_line(GContext *ctx, GPoint p0, GPoint p1) {
+  int width = MAX(ctx->stroke_width, 1);
+  int dx = abs(p1.x - p0.x);
+  int dy = -abs(p1.y - p0.y);
+  int step_x = (p0.x < p1.x) ? 1 : -1;
+  int step_y = (p0.y < p1.y) ? 1 : -1;
+  int error = dx + dy;
+  for (;;) {
+    if (width == 1) {
+      put_pixel(ctx, p0.x, p0.y, ctx->stroke_color);
+    } else {
+      fill_rect_with(ctx, GRect(p0.x - width / 2, p0.y - width / 2, width, width), ctx->stroke_color);
+    }
+    if (p0.x == p1.x && p0.y == p1.y) {
+      break;
+    }
+    int doubled = 2 * error;
+    if (doubled >= dy) {
+      error += dy;
+      p0.x += step_x;
+    }
+    if (doubled <= dx) {
+      error += dx;
+      p0.y += step_y;
+    }
+  }
+}
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+  bench_counters.graphics_calls++;
+  put_pixel(ctx, point.x, point.y, ctx->stroke_color);
+}
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  bench_counters.graphics_calls++;
+  fill_rect_with(ctx, rect, ctx->fill_color);
+}
+void graphics_draw_round_rect(GContext *ctx, GRect rect, uint16_t radius) {
+  bench_counters.graphics_calls++;
+  GPoint corners[] = {
+    rect.origin, GPoint(rect.origin.x + rect.size.w - 1, rect.origin.y),
+    GPoint(rect.origin.x + rect.size.w - 1, rect.origin.y + rect.size.h - 1),
+    GPoint(rect.origin.x, rect.origin.y + rect.size.h - 1),
+  };
+  for (int i = 0; i < 4; i++) {
+    stroke_line(ctx, corners[i], corners[(i + 1) % 4]);
+  }
+}
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  bench_counters.graphics_calls++;
+  stroke_line(ctx, p0, p1);
+}
+static GColor bitmap_pixel(const GBitmap *bitmap, int x, int y) {
+  const uint8_t *row = bitmap->data + y * bitmap->bytes_per_row;
+  switch (bitmap->format) {
+    case GBitmapFormat8Bit: case GBitmapFormat8BitCircular: return (GColor) { .argb = row[x] };
+    case GBitmapFormat2BitPalette: return bitmap->palette[(row[x / 4] >> (6 - 2 * (x % 4))) & 0x3];
+    case GBitmapFormat4BitPalette: return bitmap->palette[(row[x / 2] >> (4 - 4 * (x % 2))) & 0xf];
+    default: return (row[x / 8] & (0x80 >> (x % 8))) ? GColorWhite : GColorBlack;
+  }
+}
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  bench_counters.graphics_calls++;
+  bench_counters.bitmap_draws++;
+  rect.size.w = MIN(rect.size.w, bitmap->bounds.size.w);
+  rect.size.h = MIN(rect.size.h, bitmap->bounds.size.h);
+  GRect area = clip_rect(ctx, rect);
+  for (int y = area.origin.y; y < area.origin.y + area.size.h; y++) {
+    int source_x = area.origin.x - ctx->origin.x - rect.origin.x;
+    int source_y = y - ctx->origin.y - rect.origin.y;
+    uint8_t *destination = &s_pixels[y * SCREEN_WIDTH + area.origin.x];
+    if (bitmap->format == GBitmapFormat8Bit || bitmap->format == GBitmapFormat8BitCircular) {
+      memcpy(destination, bitmap->data + source_y * bitmap->bytes_per_row + source_x, area.size.w);
+      continue;
+    }
+    for (int x = 0; x < area.size.w; x++) {
+      GColor color = bitmap_pixel(bitmap, source_x + x, source_y);
+      if (ctx->compositing_mode == GCompOpAssignInverted) {
+        color = gcolor_equal(color, GColorBlack) ? GColorWhite : GColorBlack;
+      }
+      destination[x] = screen_color(color);
+    }
+  }
+  bench_counters.pixels_touched += area.size.w * area.size.h;
+}
+// Stands in for glyphs with a pattern that depends on the characters, 8 pixels per character.
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes) {
+  bench_counters.graphics_calls++;
+  bench_counters.text_draws++;
+  int width = MIN((int) strlen(text) * 8, box.size.w);
+  int left = box.origin.x + (box.size.w - width) / 2;
+  for (int y = 4; y < MIN(box.size.h, 18); y++) {
+    for (int x = 0; x < width; x++) {
+      if ((text[x / 8] * 7 + x * 3 + y * 5) % 4 == 0) {
+        put_pixel(ctx, left + x, box.origin.y + y, ctx->text_color);
+      }
+    }
+  }
+}
+#if defined(BENCH_APLITE)
+static uint8_t s_packed_pixels[(SCREEN_WIDTH + 31) / 32 * 4 * SCREEN_HEIGHT];
+static GBitmap s_packed_frame_buffer = {
+  .data = s_packed_pixels,
+  .bounds = {{0, 0}, {SCREEN_WIDTH, SCREEN_HEIGHT}},
+  .format = GBitmapFormat1Bit,
+  .bytes_per_row = (SCREEN_WIDTH + 31) / 32 * 4,
+};
+#endif
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  bench_counters.graphics_calls++;
+#if defined(BENCH_APLITE)
+  memset(s_packed_pixels, 0, sizeof(s_packed_pixels));
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      if (s_pixels[y * SCREEN_WIDTH + x] == GColorWhite.argb) {
+        s_packed_pixels[y * s_packed_frame_buffer.bytes_per_row + x / 8] |= 0x80 >> (x % 8);
+      }
+    }
+  }
+  return &s_packed_frame_buffer;
+#else
+  return ctx->frame_buffer;
+#endif
+}
+// Nothing in src/ writes to the captured frame buffer, so it is not copied back.
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  return true;
+}
+
+// Paths
+
+GPath *gpath_create(const GPathInfo *init) {
+  bench_counters.gpath_creates++;
+  GPath *path = bench_calloc(1, sizeof(GPath));
+  path->info = *init;
+  return path;
+}
+void gpath_destroy(GPath *path) {
+  bench_counters.gpath_destroys++;
+  bench_free(path);
+}
+void gpath_move_to(GPath *path, GPoint point) {
+  path->offset = point;
+}
+void gpath_rotate_to(GPath *path, int32_t angle) {
+  path->rotation = angle;
+}
+// Rotates and moves a path point the way the firmware does, without counting trig lookups.
+static GPoint transform_point(const GPath *path, GPoint point) {
+  int32_t sine = (int32_t) lround(sin(2 * M_PI * path->rotation / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+  int32_t cosine = (int32_t) lround(cos(2 * M_PI * path->rotation / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+  return GPoint(point.x * cosine / TRIG_MAX_RATIO - point.y * sine / TRIG_MAX_RATIO + path->offset.x,
+                point.y * cosine / TRIG_MAX_RATIO + point.x * sine / TRIG_MAX_RATIO + path->offset.y);
+}
+// Even-odd scanline fill sampled at pixel centers.
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+  bench_counters.graphics_calls++;
+  int count = path->info.num_points;
+  GPoint points[count];
+  int top = INT16_MAX;
+  int bottom = INT16_MIN;
+  for (int i = 0; i < count; i++) {
+    points[i] = transform_point(path, path->info.points[i]);
+    top = MIN(top, points[i].y);
+    bottom = MAX(bottom, points[i].y);
+  }
+  for (int y = top; y <= bottom; y++) {
+    double center_y = y + 0.5;
+    double crossings[count];
+    int crossing_count = 0;
+    for (int i = 0; i < count; i++) {
+      GPoint a = points[i];
+      GPoint b = points[(i + 1) % count];
+      if ((a.y <= center_y) != (b.y <= center_y)) {
+        crossings[crossing_count++] = a.x + (center_y - a.y) * (b.x - a.x) / (double) (b.y - a.y);
+      }
+    }
+    for (int i = 1; i < crossing_count; i++) {
+      for (int j = i; j > 0 && crossings[j - 1] > crossings[j]; j--) {
+        double swap = crossings[j];
+        crossings[j] = crossings[j - 1];
+        crossings[j - 1] = swap;
+      }
+    }
+    for (int i = 0; i + 1 < crossing_count; i += 2) {
+      for (int x = (int) ceil(crossings[i] - 0.5); x + 0.5 < crossings[i + 1]; x++) {
+        put_pixel(ctx, x, y, ctx->fill_color);
+      }
+    }
+  }
+}
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+  bench_counters.graphics_calls++;
+  int count = path->info.num_points;
+  for (int i = 0; i < count; i++) {
+    stroke_line(ctx, transform_point(path, path->info.points[i]),
+                transform_point(path, path->info.points[(i + 1) % count]));
+  }
+}
+
+// Layers and windows
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = bench_calloc(1, sizeof(Layer));
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+  return layer;
+}
+void layer_destroy(Layer *layer) {
+  bench_free(layer);
+}
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+void layer_mark_dirty(Layer *layer) {
+  s_dirty = true;
+}
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+GRect layer_get_bounds(const Layer *layer) {
+  return layer->bounds;
+}
+void layer_set_bounds(Layer *layer, GRect bounds) {
+  layer->bounds = bounds;
+  s_dirty = true;
+}
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+  s_dirty = true;
+}
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden != hidden) {
+    layer->hidden = hidden;
+    s_dirty = true;
+  }
+}
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+void layer_add_child(Layer *parent, Layer *child) {
+  if (parent->child_count < MAX_CHILDREN) {
+    parent->children[parent->child_count++] = child;
+  }
+}
+Window *window_create(void) {
+  Window *window = bench_calloc(1, sizeof(Window));
+  window->root_layer = layer_create(GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+  window->background_color = GColorWhite;
+  return window;
+}
+void window_set_background_color(Window *window, GColor background_color) {
+  window->background_color = background_color;
+}
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+void window_destroy(Window *window) {
+  layer_destroy(window->root_layer);
+  bench_free(window);
+}
+Layer *window_get_root_layer(const Window *window) {
+  return window->root_layer;
+}
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  s_dirty = true;
+  if (window->handlers.load) {
+    window->handlers.load(window);
+  }
+  if (window->handlers.appear) {
+    window->handlers.appear(window);
+  }
+}
+// `parent_origin' is the screen position of the parent's bounds origin, `parent_clip' its visible area.
+static void render_layer(Layer *layer, GPoint parent_origin, GRect parent_clip) {
+  if (layer->hidden) {
+    return;
+  }
+  GRect frame = GRect(parent_origin.x + layer->frame.origin.x, parent_origin.y + layer->frame.origin.y,
+                      layer->frame.size.w, layer->frame.size.h);
+  GRect clip = s_unclipped ? parent_clip : intersect_rect(frame, parent_clip);
+  GPoint origin = GPoint(frame.origin.x + layer->bounds.origin.x, frame.origin.y + layer->bounds.origin.y);
+  if (layer->update_proc) {
+    bench_counters.layer_redraws++;
+    s_context.origin = origin;
+    s_context.clip = clip;
+    if (s_unclipped) {
+      // Draw procs that skip what lies outside their frame see a frame covering all of their bounds.
+      GRect saved_frame = layer->frame;
+      GRect saved_bounds = layer->bounds;
+      layer->frame = GRect(origin.x - parent_origin.x, origin.y - parent_origin.y, layer->bounds.size.w, layer->bounds.size.h);
+      layer->bounds.origin = GPointZero;
+      layer->update_proc(layer, &s_context);
+      layer->frame = saved_frame;
+      layer->bounds = saved_bounds;
+    } else {
+      layer->update_proc(layer, &s_context);
+    }
+  }
+  for (int i = 0; i < layer->child_count; i++) {
+    render_layer(layer->children[i], origin, clip);
+  }
+}
+// Like the firmware, any dirty layer causes the whole window to be redrawn, and
+// the window's background color, unless clear, is filled in first.
+static void render_window(Window *window) {
+  GRect screen = GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  if (window->background_color.argb != GColorClear.argb) {
+    s_context.origin = GPoint(0, 0);
+    s_context.clip = screen;
+    fill_rect_with(&s_context, screen, window->background_color);
+  }
+  render_layer(window->root_layer, GPoint(0, 0), screen);
+}
+// Redraws everything with layer frames ignored and returns how many pixels differ from the last frame.
+// Counters and the frame buffer are put back afterwards, so the check does not change the run.
+// On round displays only the pixels inside the circle are compared.
+static long verify_frame(void) {
+  static uint8_t rendered[sizeof(s_pixels)];
+  BenchCounters counters = bench_counters;
+  memcpy(rendered, s_pixels, sizeof(s_pixels));
+  memset(s_pixels, 0, sizeof(s_pixels));
+  s_unclipped = true;
+  render_window(s_top_window);
+  s_unclipped = false;
+  long mismatched = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    int16_t min_x;
+    int16_t max_x;
+    visible_span(&s_frame_buffer, y, &min_x, &max_x);
+    for (int i = y * SCREEN_WIDTH + min_x; i <= y * SCREEN_WIDTH + max_x; i++) {
+      mismatched += s_pixels[i] != rendered[i];
+    }
+  }
+  memcpy(s_pixels, rendered, sizeof(s_pixels));
+  bench_counters = counters;
+  return mismatched;
+}
+void bench_set_verify_interval(int interval) {
+  s_verify_interval = interval;
+}
+void bench_render(void) {
+  if (!s_dirty || !s_top_window) {
+    return;
+  }
+  s_dirty = false;
+  bench_counters.frames++;
+  render_window(s_top_window);
+  if (s_verify_interval > 0 && bench_counters.frames % s_verify_interval == 0) {
+    long mismatched = verify_frame();
+    bench_counters.verified_frames++;
+    bench_counters.mismatched_pixels += mismatched;
+  }
+}
+
+// Persistent storage
+
+typedef struct {
+  bool used;
+  uint32_t key;
+  size_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+static PersistEntry s_persist[MAX_PERSIST_KEYS];
+
+static PersistEntry *persist_find(uint32_t key, bool create) {
+  PersistEntry *free_entry = NULL;
+  for (int i = 0; i < MAX_PERSIST_KEYS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) {
+      return &s_persist[i];
+    }
+    if (!s_persist[i].used && !free_entry) {
+      free_entry = &s_persist[i];
+    }
+  }
+  if (create && free_entry) {
+    free_entry->used = true;
+    free_entry->key = key;
+    free_entry->size = 0;
+    return free_entry;
+  }
+  return NULL;
+}
+bool persist_exists(const uint32_t key) {
+  bench_counters.persist_reads++;
+  return persist_find(key, false) != NULL;
+}
+int persist_get_size(const uint32_t key) {
+  bench_counters.persist_reads++;
+  PersistEntry *entry = persist_find(key, false);
+  return entry ? (int) entry->size : -1;
+}
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  bench_counters.persist_reads++;
+  PersistEntry *entry = persist_find(key, false);
+  if (!entry) {
+    return -1;
+  }
+  size_t size = MIN(entry->size, buffer_size);
+  memcpy(buffer, entry->data, size);
+  return (int) size;
+}
+bool persist_read_bool(const uint32_t key) {
+  return persist_read_int(key) != 0;
+}
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  bench_counters.persist_writes++;
+  PersistEntry *entry = persist_find(key, true);
+  if (!entry) {
+    return -1;
+  }
+  entry->size = MIN(size, PERSIST_DATA_MAX_LENGTH);
+  memcpy(entry->data, data, entry->size);
+  return (int) entry->size;
+}
+status_t persist_write_bool(const uint32_t key, const bool value) {
+  return persist_write_int(key, value);
+}
+status_t persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value)) < 0 ? -1 : 0;
+}
+status_t persist_delete(const uint32_t key) {
+  PersistEntry *entry = persist_find(key, false);
+  if (entry) {
+    entry->used = false;
+  }
+  return 0;
+}
+
+// AppMessage
+
+// No phone answers, so the outbox only counts what is sent.
+struct DictionaryIterator {
+  uint32_t bytes;
+};
+static DictionaryIterator s_outbox;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+  return NULL;
+}
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+  iter->bytes += sizeof(Tuple) + sizeof(value);
+  return DICT_OK;
+}
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t * const data, const uint16_t size) {
+  iter->bytes += sizeof(Tuple) + size;
+  return DICT_OK;
+}
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  // The firmware takes both buffers from the app heap.
+  void *buffers = bench_malloc(size_inbound + size_outbound);
+  (void) buffers;
+  return APP_MSG_OK;
+}
+uint32_t app_message_inbox_size_maximum(void) {
+  return 8200;
+}
+uint32_t app_message_outbox_size_maximum(void) {
+  return 8200;
+}
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback) {}
+void app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {}
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {}
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {}
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+  s_outbox.bytes = 1;
+  *iterator = &s_outbox;
+  return APP_MSG_OK;
+}
+AppMessageResult app_message_outbox_send(void) {
+  bench_counters.messages_sent++;
+  bench_counters.message_bytes_sent += s_outbox.bytes;
+  return APP_MSG_OK;
+}
+
+// Event loop
+
+void bench_set_event_loop(void (*event_loop)(void)) {
+  s_event_loop = event_loop;
+}
+void app_event_loop(void) {
+  if (s_event_loop) {
+    s_event_loop();
+  }
+}
@@ -0,0 +1,21 @@
+#include "test.h"
+
+// Runs every suite and prints one JSON line with the totals; exits non-zero if any check failed.
+
+int test_checks;
+int test_failures;
+
+int main(int argc, char **argv) {
+  test_bezel();
+  test_power_policy();
+  test_schedule();
+  test_sweep();
+#if defined(PROFILER_ENABLED)
+  const bool profiler = true;
+#else
+  const bool profiler = false;
+#endif
+  printf("{\"platform\": \"%s\", \"profiler\": %s, \"checks\": %d, \"failures\": %d}\n", BENCH_PLATFORM_NAME,
+         profiler ? "true" : "false", test_checks, test_failures);
+  return (test_failures > 0) ? 1 : 0;
+}
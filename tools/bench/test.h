@@ -0,0 +1,24 @@
+#pragma once
+#include <stdio.h>
+#include "bench.h"
+
+// Host unit tests, built against the same fake SDK as the bench; see `bench.py --test'.
+
+extern int test_checks;
+extern int test_failures;
+
+// Counts a check, and reports it with a printf-style message when `condition' is false.
+#define CHECK(condition, ...) do { \
+    test_checks++; \
+    if (!(condition)) { \
+      test_failures++; \
+      fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+      fprintf(stderr, __VA_ARGS__); \
+      fputc('\n', stderr); \
+    } \
+  } while (0)
+
+void test_bezel(void);
+void test_power_policy(void);
+void test_schedule(void);
+void test_sweep(void);
@@ -0,0 +1,171 @@
+#include "test.h"
+#include "../../src/bezel.h"
+
+// The formula the draw procs evaluated on every redraw before the length tables, on the 144x168
+// screen: the distance to the side edges for minutes 7-23 and 37-53, to the top or bottom otherwise.
+static int original_minute_length(int minute) {
+  int32_t angle = (TRIG_MAX_ANGLE / 60) * minute;
+  int length;
+  if ((minute >= 7 && minute <= 23) || (minute >= 37 && minute <= 53)) {
+    length = (72 * TRIG_MAX_ANGLE) / cos_lookup(angle - TRIG_MAX_ANGLE / 4);
+  } else {
+    length = (84 * TRIG_MAX_ANGLE) / cos_lookup(angle - TRIG_MAX_ANGLE / 2);
+  }
+  return ABS(length);
+}
+// The same for the hour hand, which switched edges at whole degrees 49-139 and 229-311.
+static int original_hour_length(int32_t angle, int degrees) {
+  int length;
+  if ((degrees >= 49 && degrees <= 139) || (degrees >= 229 && degrees <= 311)) {
+    length = (72 * TRIG_MAX_ANGLE) / cos_lookup(angle - TRIG_MAX_ANGLE / 4);
+  } else {
+    length = (84 * TRIG_MAX_ANGLE) / cos_lookup(angle - TRIG_MAX_ANGLE / 2);
+  }
+  return ABS(length);
+}
+// Both of the original formula's edges, whichever is nearer.
+static int edge_clamped_length(int32_t angle) {
+  int32_t side_cos = cos_lookup(angle - TRIG_MAX_ANGLE / 4);
+  int32_t top_cos = cos_lookup(angle - TRIG_MAX_ANGLE / 2);
+  int side = (side_cos != 0) ? ABS((72 * TRIG_MAX_ANGLE) / side_cos) : INT16_MAX;
+  int top = (top_cos != 0) ? ABS((84 * TRIG_MAX_ANGLE) / top_cos) : INT16_MAX;
+  return MIN(side, top);
+}
+
+// Where a hand `length' pixels long points at `angle', rotated like the fake SDK's gpath.
+static GPoint tip_at(GRect screen, int32_t angle, int length) {
+  GPoint center = grect_center_point(&screen);
+  return GPoint(center.x + length * sin_lookup(angle) / TRIG_MAX_RATIO,
+                center.y - length * cos_lookup(angle) / TRIG_MAX_RATIO);
+}
+// Whether the display shows `point', going by the frame buffer's row spans.
+static bool shows(const GBitmap *frame, GPoint point) {
+  GRect bounds = gbitmap_get_bounds(frame);
+  if (!grect_contains_point(&bounds, &point)) {
+    return false;
+  }
+  GBitmapDataRowInfo row = gbitmap_get_data_row_info(frame, point.y);
+  return point.x >= row.min_x && point.x <= row.max_x;
+}
+// The tip is the last pixel shown along the ray, and `length' the shortest that reaches it.
+static bool tip_on_bezel(const GBitmap *frame, int32_t angle, int length) {
+  GRect screen = gbitmap_get_bounds(frame);
+  GPoint tip = tip_at(screen, angle, length);
+  GPoint shorter = tip_at(screen, angle, length - 1);
+  if (!shows(frame, tip) || gpoint_equal(&shorter, &tip)) {
+    return false;
+  }
+  // A step along the ray moves the tip by at most a pixel, so a few steps reach the next pixel out.
+  for (int further = length + 1; further <= length + 3; further++) {
+    GPoint beyond = tip_at(screen, angle, further);
+    if (!gpoint_equal(&beyond, &tip) && shows(frame, beyond)) {
+      return false;
+    }
+  }
+  return true;
+}
+static GBitmap *create_screen(GSize size) {
+  return gbitmap_create_blank(size, PBL_IF_ROUND_ELSE(GBitmapFormat8BitCircular, GBitmapFormat8Bit));
+}
+
+#if !defined(PBL_ROUND)
+// Every second/minute entry is what the original formula gave for that position, except where the
+// formula's tip fell one pixel off the screen or short of its edge.
+static void test_minute_table_matches_formula(void) {
+  GBitmap *frame = create_screen(GSize(144, 168));
+  uint8_t lengths[MINUTE_HAND_STEPS];
+  bezel_build_table(lengths, MINUTE_HAND_STEPS, GRect(0, 0, 144, 168));
+  for (int minute = 0; minute < MINUTE_HAND_STEPS; minute++) {
+    int32_t angle = (TRIG_MAX_ANGLE / MINUTE_HAND_STEPS) * minute;
+    int expected = original_minute_length(minute);
+    CHECK(lengths[minute] == expected || (ABS(lengths[minute] - expected) <= 2 && !tip_on_bezel(frame, angle, expected)),
+          "minute %d: table %d, formula %d", minute, lengths[minute], expected);
+  }
+  gbitmap_destroy(frame);
+}
+// Every half degree of the hour hand stops at the nearer edge. That is what the original formula
+// gave, except where its whole-degree ranges picked the farther edge: 41-48 degrees and the mirrored spans.
+static bool in_far_edge_span(int degrees) {
+  return (degrees >= 41 && degrees <= 48) || (degrees >= 221 && degrees <= 228) || (degrees >= 312 && degrees <= 319);
+}
+static void test_hour_table_matches_formula(void) {
+  GBitmap *frame = create_screen(GSize(144, 168));
+  uint8_t lengths[HOUR_HAND_STEPS];
+  bezel_build_table(lengths, HOUR_HAND_STEPS, GRect(0, 0, 144, 168));
+  for (int step = 0; step < HOUR_HAND_STEPS; step++) {
+    int32_t angle = (TRIG_MAX_ANGLE / HOUR_HAND_STEPS) * step;
+    int expected = edge_clamped_length(angle);
+    CHECK(lengths[step] == expected || (ABS(lengths[step] - expected) <= 2 && !tip_on_bezel(frame, angle, expected)),
+          "hour step %d: table %d, formula %d", step, lengths[step], expected);
+    int original = original_hour_length(angle, step / 2);
+    CHECK(original == expected || (in_far_edge_span(step / 2) && original > expected),
+          "hour step %d: table %d, original formula %d", step, lengths[step], original);
+  }
+  gbitmap_destroy(frame);
+}
+#endif
+
+// On this platform's screen, every entry of both tables puts a zero-offset hand's tip on the last
+// pixel the display shows along its ray.
+static void test_tips_reach_bezel(void) {
+  Window *window = window_create();
+  GRect screen = layer_get_bounds(window_get_root_layer(window));
+  GBitmap *frame = create_screen(screen.size);
+  uint8_t minute_lengths[MINUTE_HAND_STEPS];
+  uint8_t hour_lengths[HOUR_HAND_STEPS];
+  bezel_build_table(minute_lengths, MINUTE_HAND_STEPS, screen);
+  bezel_build_table(hour_lengths, HOUR_HAND_STEPS, screen);
+  for (int minute = 0; minute < MINUTE_HAND_STEPS; minute++) {
+    int32_t angle = (TRIG_MAX_ANGLE / MINUTE_HAND_STEPS) * minute;
+    GPoint tip = tip_at(screen, angle, minute_lengths[minute]);
+    CHECK(tip_on_bezel(frame, angle, minute_lengths[minute]), "minute %d: tip at %d,%d", minute, tip.x, tip.y);
+  }
+  for (int step = 0; step < HOUR_HAND_STEPS; step++) {
+    int32_t angle = (TRIG_MAX_ANGLE / HOUR_HAND_STEPS) * step;
+    GPoint tip = tip_at(screen, angle, hour_lengths[step]);
+    CHECK(tip_on_bezel(frame, angle, hour_lengths[step]), "hour step %d: tip at %d,%d", step, tip.x, tip.y);
+  }
+  gbitmap_destroy(frame);
+  window_destroy(window);
+}
+// The tips at the quarter hours and at 1:30, 4:30, 7:30 and 10:30, by half-degree step. The center
+// pixel is the one right of and below the middle, so the left and top edges are a pixel further away.
+typedef struct {
+  int step;
+  GPoint tip;
+} ExpectedTip;
+static const ExpectedTip s_expected_tips[] = {
+#if defined(PBL_PLATFORM_CHALK)
+  { 0, { 90, 0 } }, { 90, { 153, 27 } }, { 180, { 179, 90 } }, { 270, { 153, 153 } },
+  { 360, { 90, 179 } }, { 450, { 27, 153 } }, { 540, { 0, 90 } }, { 630, { 26, 26 } },
+#elif defined(PBL_PLATFORM_EMERY)
+  { 0, { 100, 0 } }, { 90, { 199, 15 } }, { 180, { 199, 114 } }, { 270, { 199, 213 } },
+  { 360, { 100, 227 } }, { 450, { 0, 214 } }, { 540, { 0, 114 } }, { 630, { 0, 14 } },
+#else
+  { 0, { 72, 0 } }, { 90, { 143, 13 } }, { 180, { 143, 84 } }, { 270, { 143, 155 } },
+  { 360, { 72, 167 } }, { 450, { 0, 156 } }, { 540, { 0, 84 } }, { 630, { 0, 12 } },
+#endif
+};
+static void test_expected_tips(void) {
+  Window *window = window_create();
+  GRect screen = layer_get_bounds(window_get_root_layer(window));
+  uint8_t hour_lengths[HOUR_HAND_STEPS];
+  bezel_build_table(hour_lengths, HOUR_HAND_STEPS, screen);
+  for (size_t i = 0; i < ARRAY_LENGTH(s_expected_tips); i++) {
+    const ExpectedTip *expected = &s_expected_tips[i];
+    int32_t angle = (TRIG_MAX_ANGLE / HOUR_HAND_STEPS) * expected->step;
+    GPoint tip = tip_at(screen, angle, hour_lengths[expected->step]);
+    CHECK(gpoint_equal(&tip, &expected->tip), "hour step %d: tip at %d,%d, expected %d,%d",
+          expected->step, tip.x, tip.y, expected->tip.x, expected->tip.y);
+  }
+  window_destroy(window);
+}
+
+void test_bezel(void) {
+#if !defined(PBL_ROUND)
+  test_minute_table_matches_formula();
+  test_hour_table_matches_formula();
+#endif
+  test_tips_reach_bezel();
+  test_expected_tips();
+}
@@ -0,0 +1,41 @@
+#include "test.h"
+#include "../../src/power_policy.h"
+
+static const uint8_t s_thresholds[POWER_THRESHOLD_COUNT] = POWER_DEFAULT_THRESHOLDS;
+
+static PowerTier update(uint8_t charge_percent, bool is_charging) {
+  BatteryChargeState charge_state = { .charge_percent = charge_percent, .is_charging = is_charging,
+                                      .is_plugged = is_charging };
+  return power_policy_update(charge_state, s_thresholds);
+}
+
+// A reading wobbling one 10% step above the threshold keeps the tier; two steps leave it.
+static void test_hysteresis(void) {
+  update(100, true);
+  CHECK(update(30, false) == POWER_TIER_NO_SECONDS, "30%% does not stop second ticks");
+  CHECK(update(40, false) == POWER_TIER_NO_SECONDS, "40%% left the tier entered at 30%%");
+  CHECK(update(30, false) == POWER_TIER_NO_SECONDS, "back at 30%% left the tier");
+  CHECK(update(50, false) == POWER_TIER_FULL, "50%% did not restore second ticks");
+  CHECK(update(41, false) == POWER_TIER_FULL, "41%% entered a tier");
+}
+
+// A reading that jumps clears every tier it is clear of in one update.
+static void test_jump_clears_several_tiers(void) {
+  update(100, true);
+  CHECK(update(10, false) == POWER_TIER_STATIC, "10%% is not the static tier");
+  CHECK(update(30, false) == POWER_TIER_NO_INFO_WINDOWS, "a jump to 30%% stopped at tier %d", power_policy_get_tier());
+  update(10, false);
+  CHECK(update(60, false) == POWER_TIER_FULL, "a jump to 60%% stopped at tier %d", power_policy_get_tier());
+}
+
+static void test_charging_restores_everything(void) {
+  update(100, true);
+  update(5, false);
+  CHECK(update(5, true) == POWER_TIER_FULL, "charging at 5%% left tier %d", power_policy_get_tier());
+}
+
+void test_power_policy(void) {
+  test_hysteresis();
+  test_jump_clears_several_tiers();
+  test_charging_restores_everything();
+}
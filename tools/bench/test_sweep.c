@@ -0,0 +1,102 @@
+#include "test.h"
+#include "../../src/sweep.h"
+#include "../../src/battery_monitor.h"
+
+// Drives the sweep loop on the fake clock, with every frame taking `s_frame_cost_ms'.
+
+#define START_TIME 1700000000
+
+static uint32_t s_frame_cost_ms;
+static int s_stops;
+static time_t s_now;
+// The lowest achieved rate any frame saw.
+static uint8_t s_lowest_achieved_fps;
+
+static void frame_handler(int32_t angle) {
+  s_lowest_achieved_fps = MIN(s_lowest_achieved_fps, sweep_get_achieved_fps());
+  sweep_frame_begin();
+  bench_spend_ms(s_frame_cost_ms);
+  sweep_frame_end();
+}
+static void stopped_handler(void) {
+  s_stops++;
+}
+static void set_battery(uint8_t charge_percent, bool is_charging) {
+  bench_set_battery(charge_percent, is_charging);
+  battery_monitor_update(battery_state_service_peek());
+}
+static void run_for(int seconds) {
+  s_now += seconds;
+  bench_advance_to(s_now);
+}
+// A fresh loop at a 30 fps cap on a full battery.
+static void start(uint32_t frame_cost_ms) {
+  s_now = START_TIME;
+  bench_set_time(s_now);
+  set_battery(100, false);
+  s_frame_cost_ms = frame_cost_ms;
+  s_stops = 0;
+  sweep_set_fps_cap(30);
+  sweep_start(frame_handler, stopped_handler);
+}
+
+static void test_restart_keeps_window(void) {
+  start(1);
+  run_for(3);
+  uint8_t achieved = sweep_get_achieved_fps();
+  CHECK(achieved >= 29, "achieved %d fps at a 30 fps cap", achieved);
+  sweep_stop();
+  run_for(100);
+  // The first frame after a restart must not close the window left over from before the stop.
+  s_lowest_achieved_fps = UINT8_MAX;
+  sweep_start(frame_handler, stopped_handler);
+  run_for(2);
+  CHECK(s_lowest_achieved_fps >= 29, "a restart reported %d fps achieved", s_lowest_achieved_fps);
+  sweep_stop();
+}
+
+static void test_expensive_frames_step_down_then_up(void) {
+  start(20);
+  run_for(2);
+  CHECK(sweep_get_fps() == 10, "20 ms frames run at %d fps, expected 10", sweep_get_fps());
+  s_frame_cost_ms = 10;
+  run_for(30);
+  CHECK(sweep_get_fps() == 10, "stepped up to %d fps before a minute passed", sweep_get_fps());
+  run_for(35);
+  CHECK(sweep_get_fps() == 30, "10 ms frames run at %d fps a minute later, expected 30", sweep_get_fps());
+  sweep_stop();
+}
+
+static void test_gave_up_retries_after_a_minute(void) {
+  start(300);
+  run_for(5);
+  CHECK(!sweep_is_available() && s_stops == 1, "300 ms frames still sweep at %d fps", sweep_get_fps());
+  s_frame_cost_ms = 1;
+  run_for(30);
+  CHECK(!sweep_recover(), "retried before a minute passed");
+  run_for(35);
+  CHECK(sweep_recover() && sweep_get_fps() == 4, "retried at %d fps a minute later, expected 4", sweep_get_fps());
+}
+
+static void test_charging_restores_cap(void) {
+  start(1);
+  set_battery(20, false);
+  run_for(5);
+  CHECK(!sweep_is_available() && s_stops == 1, "still sweeping at %d fps on 20%%", sweep_get_fps());
+  run_for(120);
+  CHECK(!sweep_recover(), "recovered on 20%% without charging");
+  set_battery(20, true);
+  CHECK(sweep_recover() && sweep_get_fps() == 30, "charging restored %d fps, expected 30", sweep_get_fps());
+  set_battery(40, false);
+  sweep_start(frame_handler, stopped_handler);
+  run_for(5);
+  CHECK(sweep_get_fps() == 30, "sweeping at %d fps on 40%%, expected 30", sweep_get_fps());
+  sweep_stop();
+}
+
+void test_sweep(void) {
+  test_restart_keeps_window();
+  test_expensive_frames_step_down_then_up();
+  test_gave_up_retries_after_a_minute();
+  test_charging_restores_cap();
+}
@@ -0,0 +1,102 @@
+#!/usr/bin/env python
+#
+# Writes resources/images/clockface_marks~bw.png, the 1-bit clockface aplite
+# uses, from the 2-bit coverage art in clockface_marks.png. A pixel is a mark
+# (white) when at least half of it is covered; the watch inverts the whole
+# bitmap for the light theme.
+#
+#   python tools/clockface_bw.py [--out resources/images/clockface_marks~bw.png]
+#
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+ROOT_DIR = os.path.abspath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+SOURCE = os.path.join(ROOT_DIR, 'resources', 'images', 'clockface_marks.png')
+THRESHOLD = 2
+
+
+def read_chunks(data):
+    position = 8
+    while position < len(data):
+        length, kind = struct.unpack('>I4s', data[position:position + 8])
+        yield kind, data[position + 8:position + 8 + length]
+        position += 12 + length
+
+
+# Only what clockface_marks.png uses: palettized, 2 bits per pixel, no interlacing.
+def read_coverage(path):
+    with open(path, 'rb') as source:
+        chunks = list(read_chunks(source.read()))
+    header = dict(chunks)[b'IHDR']
+    width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', header)
+    if (depth, color_type, interlace) != (2, 3, 0):
+        raise ValueError('{} is not a 2-bit palettized PNG'.format(path))
+    palette = dict(chunks)[b'PLTE']
+    levels = [palette[3 * i] >> 6 for i in range(len(palette) // 3)]
+    raw = zlib.decompress(b''.join(body for kind, body in chunks if kind == b'IDAT'))
+    stride = (width * depth + 7) // 8
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        row = unfilter(raw[start], bytearray(raw[start + 1:start + 1 + stride]), previous)
+        rows.append([levels[(row[x // 4] >> (6 - 2 * (x % 4))) & 0x3] for x in range(width)])
+        previous = row
+    return width, height, rows
+
+
+def unfilter(kind, row, previous):
+    for i in range(len(row)):
+        left = row[i - 1] if i > 0 else 0
+        up = previous[i]
+        up_left = previous[i - 1] if i > 0 else 0
+        if kind == 1:
+            row[i] = (row[i] + left) & 0xff
+        elif kind == 2:
+            row[i] = (row[i] + up) & 0xff
+        elif kind == 3:
+            row[i] = (row[i] + (left + up) // 2) & 0xff
+        elif kind == 4:
+            estimate = left + up - up_left
+            nearest = min((abs(estimate - left), 0, left), (abs(estimate - up), 1, up),
+                          (abs(estimate - up_left), 2, up_left))
+            row[i] = (row[i] + nearest[2]) & 0xff
+    return row
+
+
+def chunk(kind, body):
+    return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff)
+
+
+def write_bw(path, width, height, rows):
+    raw = bytearray()
+    for row in rows:
+        packed = bytearray((width + 7) // 8)
+        for x, level in enumerate(row):
+            if level >= THRESHOLD:
+                packed[x // 8] |= 0x80 >> (x % 8)
+        raw += b'\0' + packed
+    with open(path, 'wb') as out:
+        out.write(b'\x89PNG\r\n\x1a\n')
+        out.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 1, 0, 0, 0, 0)))
+        out.write(chunk(b'IDAT', zlib.compress(bytes(raw), 9)))
+        out.write(chunk(b'IEND', b''))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--out', default=os.path.join(ROOT_DIR, 'resources', 'images', 'clockface_marks~bw.png'))
+    args = parser.parse_args(argv)
+    width, height, rows = read_coverage(SOURCE)
+    write_bw(args.out, width, height, rows)
+    marks = sum(level >= THRESHOLD for row in rows for level in row)
+    print('{}: {}x{}, {} mark pixels'.format(args.out, width, height, marks))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
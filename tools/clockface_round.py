@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+#
+# Writes resources/images/clockface_marks~round.png, the 180x180 clockface
+# chalk uses, from the 144x168 coverage art in clockface_marks.png. The art is
+# warped radially so every mark keeps its distance from the bezel: a pixel at
+# distance d from the middle samples the rectangle at R(angle) - (90 - d), where
+# R is how far the rectangle's edge is in that direction. The hands end at the
+# bezel on round, so the marks stay just inside their tips instead of 18 px in.
+# Marks near 3 and 9 come out about 1.3x wider along the bezel.
+#
+#   python tools/clockface_round.py [--out resources/images/clockface_marks~round.png]
+#
+
+import argparse
+import math
+import os
+import struct
+import sys
+import zlib
+
+from clockface_bw import SOURCE, chunk, read_coverage
+
+ROOT_DIR = os.path.abspath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+SIZE = 180
+SUPERSAMPLE = 4
+PALETTE = bytes.fromhex('000000555555aaaaaaffffff')
+
+
+def source_radius(width, height, dx, dy, distance):
+    # How far the rectangle's edge is in the direction (dx, dy), less the distance to the bezel.
+    limits = []
+    if dx:
+        limits.append(width / 2.0 * distance / abs(dx))
+    if dy:
+        limits.append(height / 2.0 * distance / abs(dy))
+    return min(limits) - (SIZE / 2.0 - distance)
+
+
+def warp(width, height, rows):
+    middle = SIZE / 2.0
+    samples = SUPERSAMPLE * SUPERSAMPLE
+    out = []
+    for y in range(SIZE):
+        row = []
+        for x in range(SIZE):
+            total = 0
+            for sample in range(samples):
+                dx = x + (sample % SUPERSAMPLE + 0.5) / SUPERSAMPLE - middle
+                dy = y + (sample // SUPERSAMPLE + 0.5) / SUPERSAMPLE - middle
+                distance = math.hypot(dx, dy)
+                if distance > middle or distance == 0:
+                    continue
+                radius = source_radius(width, height, dx, dy, distance)
+                if radius <= 0:
+                    continue
+                source_x = int(width / 2.0 + dx * radius / distance)
+                source_y = int(height / 2.0 + dy * radius / distance)
+                if 0 <= source_x < width and 0 <= source_y < height:
+                    total += rows[source_y][source_x]
+            row.append((total + samples // 2) // samples)
+        out.append(row)
+    return out
+
+
+def write_round(path, rows):
+    raw = bytearray()
+    for row in rows:
+        packed = bytearray((SIZE * 2 + 7) // 8)
+        for x, level in enumerate(row):
+            packed[x // 4] |= level << (6 - 2 * (x % 4))
+        raw += b'\0' + packed
+    with open(path, 'wb') as out:
+        out.write(b'\x89PNG\r\n\x1a\n')
+        out.write(chunk(b'IHDR', struct.pack('>IIBBBBB', SIZE, SIZE, 2, 3, 0, 0, 0)))
+        out.write(chunk(b'PLTE', PALETTE))
+        out.write(chunk(b'IDAT', zlib.compress(bytes(raw), 9)))
+        out.write(chunk(b'IEND', b''))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--out', default=os.path.join(ROOT_DIR, 'resources', 'images', 'clockface_marks~round.png'))
+    args = parser.parse_args(argv)
+    width, height, rows = read_coverage(SOURCE)
+    rows = warp(width, height, rows)
+    write_round(args.out, rows)
+    marks = sum(level > 0 for row in rows for level in row)
+    print('{}: {}x{}, {} covered pixels'.format(args.out, SIZE, SIZE, marks))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
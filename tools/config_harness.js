@@ -0,0 +1,264 @@
+#!/usr/bin/env node
+//
+// Runs src/config.js against a stand-in for the Pebble object, localStorage and
+// timers, and replays config page saves with messages the watch acknowledges or
+// rejects. Prints one JSON object per scenario with what went over the air,
+// next to what sending every key on every save would have cost.
+//
+//   [VERBOSE=1] node tools/config_harness.js [scenario ...]
+//
+
+var fs = require('fs');
+var path = require('path');
+var vm = require('vm');
+
+var CONFIG_JS = path.join(__dirname, '..', 'src', 'config.js');
+// What a watch that restored its saved settings reports at launch; see src/settings.h.
+var SETTINGS_VERSION = 6;
+
+// The AppMessage dictionary header plus, per tuple, its key, type and length, then the value.
+var DICT_HEADER_BYTES = 1;
+var TUPLE_HEADER_BYTES = 7;
+
+function messageBytes(dict) {
+  return Object.keys(dict).reduce(function(total, key) {
+    var value = dict[key];
+    return total + TUPLE_HEADER_BYTES + (Array.isArray(value) ? value.length : 4);
+  }, DICT_HEADER_BYTES);
+}
+
+// A watch that answers with the entries of `watch.replies' in order, and 'ack' once they run out.
+// Its phone keeps localStorage across launch() calls, like the real one across app launches.
+function createWatch() {
+  var now = 0;
+  var timers = [];
+  var nextTimer = 1;
+  var handlers = {};
+  var storage = {};
+  var outbox = [];
+  var context = null;
+  var watch = {
+    replies: [],
+    messages: [],
+    retries: 0,
+    settled: {}
+  };
+
+  // Starts config.js afresh; the watch then reports `settingsState', unless that is undefined,
+  // and whether it has the profiler.
+  watch.launch = function(settingsState, profiler) {
+    handlers = {};
+    outbox = [];
+    timers = [];
+    context = {
+      // config.js logs every message; VERBOSE=1 shows that on stderr.
+      console: { log: process.env.VERBOSE ? console.error : function() {} },
+      localStorage: {
+        getItem: function(key) { return (key in storage) ? storage[key] : null; },
+        setItem: function(key, value) { storage[key] = String(value); },
+        removeItem: function(key) { delete storage[key]; }
+      },
+      setTimeout: function(callback, delay) {
+        var timer = { id: nextTimer++, at: now + delay, callback: callback };
+        timers.push(timer);
+        return timer.id;
+      },
+      clearTimeout: function(id) {
+        timers = timers.filter(function(timer) { return timer.id !== id; });
+      },
+      Pebble: {
+        addEventListener: function(type, handler) { handlers[type] = handler; },
+        getWatchToken: function() { return 'harness'; },
+        openURL: function() {},
+        sendAppMessage: function(dict, success, failure) {
+          outbox.push({ dict: dict, success: success, failure: failure });
+        }
+      }
+    };
+    vm.runInNewContext(fs.readFileSync(CONFIG_JS, 'utf8'), context, { filename: CONFIG_JS });
+    handlers.ready({});
+    if (settingsState !== undefined) {
+      handlers.appmessage({ payload: { settingsState: settingsState, profilerAvailable: profiler ? 1 : 0 } });
+    }
+  };
+  // A reinstall or a discarded settings version: the watch is back on defaults.
+  watch.reinstall = function() {
+    watch.settled = {};
+    watch.launch(0);
+  };
+  watch.openConfig = function() {
+    handlers.showConfiguration({});
+  };
+  watch.save = function(config) {
+    handlers.webviewclosed({ response: encodeURIComponent(JSON.stringify(config)) });
+  };
+  // Answers the message in flight, if any.
+  watch.deliver = function() {
+    var message = outbox.shift();
+    if (!message) {
+      return false;
+    }
+    watch.messages.push(message.dict);
+    if ((watch.replies.shift() || 'ack') === 'ack') {
+      Object.keys(message.dict).forEach(function(key) { watch.settled[key] = message.dict[key]; });
+      message.success({});
+    } else {
+      watch.retries++;
+      message.failure({});
+    }
+    return true;
+  };
+  // Delivers messages and, unless `nowOnly', fires timers until nothing is left to do.
+  // With `holdAt' it stops instead once that many retries failed and another message is waiting.
+  watch.settle = function(nowOnly, holdAt) {
+    for (;;) {
+      if (holdAt !== undefined && watch.retries >= holdAt && outbox.length > 0) {
+        return;
+      }
+      if (watch.deliver()) {
+        continue;
+      }
+      if (nowOnly || timers.length === 0) {
+        return;
+      }
+      timers.sort(function(a, b) { return a.at - b.at; });
+      var timer = timers.shift();
+      now = timer.at;
+      timer.callback();
+    }
+  };
+  watch.now = function() { return now; };
+  // What the old handler sent on every save.
+  watch.fullSettings = function(config) { return context.settingsFromConfig(config); };
+  watch.launch(SETTINGS_VERSION);
+  return watch;
+}
+
+function baseConfig() {
+  return {
+    tickSetting: 1,
+    daySetting: 1,
+    batterySetting: 1,
+    secondStartSetting: 0,
+    secondEndSetting: 23,
+    digitalSetting: 1,
+    windowColorSetting: 'FFFFFF',
+    windowBorderColorSetting: '555555',
+    windowTextColorSetting: '000000',
+    lightThemeSetting: 0,
+    secondHandColorSetting: 'FF0000',
+    secondOutlineColorSetting: 'FFAAFF',
+    secondModeSetting: '0',
+    glanceDurationSetting: '10',
+    sweepSetting: '0',
+    handStyleSetting: '0',
+    schedule: [{ days: 127, start: 0, end: 1440 }]
+  };
+}
+function withChanges(changes) {
+  var config = baseConfig();
+  Object.keys(changes).forEach(function(key) { config[key] = changes[key]; });
+  return config;
+}
+
+// Each scenario starts from a watch that has acknowledged baseConfig(), unless it says otherwise,
+// then relaunches the app if it gives the settings state to report at `launch'.
+// The watch answers between batches of saves, and retry timers fire too unless `interrupt' is set.
+// With `hold' the watch leaves a message unanswered between batches once that many retries failed.
+var SCENARIOS = {
+  first_save: { fresh: true, saves: [[baseConfig()]] },
+  one_change: { saves: [[withChanges({ lightThemeSetting: 1 })]] },
+  unchanged: { saves: [[baseConfig()]] },
+  hours_change: { saves: [[withChanges({ secondStartSetting: 8 })]] },
+  // Three failures back off 1, 2 and 4 seconds before the fourth attempt gets through.
+  retry: { replies: ['nack', 'nack', 'nack'], saves: [[withChanges({ sweepSetting: '10' })]] },
+  // Saves made while a message is in flight collapse into one follow-up message.
+  collapse: {
+    saves: [[withChanges({ daySetting: 0 }), withChanges({ daySetting: 0, batterySetting: 0 }),
+             withChanges({ daySetting: 0, batterySetting: 0, handStyleSetting: '2' })]]
+  },
+  // A save while a failed message waits out its backoff replaces it and is sent at once.
+  supersede: {
+    replies: ['nack'],
+    interrupt: true,
+    saves: [[withChanges({ tickSetting: 0 })], [withChanges({ tickSetting: 0, digitalSetting: 0 })]]
+  },
+  // After running out of retries the next save still carries the lost change.
+  give_up: {
+    replies: ['nack', 'nack', 'nack', 'nack', 'nack', 'nack', 'nack', 'nack', 'nack'],
+    saves: [[withChanges({ glanceDurationSetting: '5' })], [withChanges({ glanceDurationSetting: '5', daySetting: 0 })]]
+  },
+  // A save made while the last retry is in flight is sent on its own once that retry fails.
+  give_up_in_flight: {
+    replies: ['nack', 'nack', 'nack', 'nack', 'nack', 'nack', 'nack', 'nack', 'nack'],
+    hold: 8,
+    saves: [[withChanges({ glanceDurationSetting: '5' })], [withChanges({ glanceDurationSetting: '5', daySetting: 0 })]]
+  },
+  // The app relaunches with its settings intact, and the cache still holds.
+  relaunch: { launch: SETTINGS_VERSION, saves: [[withChanges({ lightThemeSetting: 1 })]] },
+  // A reinstall lost the settings; the watch says so and the next save sends everything.
+  reinstall: { launch: 0, saves: [[withChanges({ lightThemeSetting: 1 })]] },
+  // Opening the page on a profiler build asks for a profile, and the save waits for that to be answered.
+  profile: { launch: SETTINGS_VERSION, profiler: true, open: true, saves: [[withChanges({ lightThemeSetting: 1 })]] },
+  // A watch without the profiler is never asked.
+  no_profiler: { launch: SETTINGS_VERSION, open: true, saves: [[withChanges({ lightThemeSetting: 1 })]] },
+  // Without a report from the watch the cache is not trusted for the first save.
+  unreported: { launch: 'none', saves: [[withChanges({ lightThemeSetting: 1 })], [withChanges({ lightThemeSetting: 0 })]] }
+};
+
+function run(name) {
+  var scenario = SCENARIOS[name];
+  var watch = createWatch();
+  if (!scenario.fresh) {
+    watch.save(baseConfig());
+    watch.settle();
+  }
+  if (scenario.launch === 0) {
+    watch.reinstall();
+  } else if (scenario.launch !== undefined) {
+    watch.launch(scenario.launch === 'none' ? undefined : scenario.launch, scenario.profiler);
+  }
+  if (scenario.open) {
+    watch.openConfig();
+  }
+  watch.messages = [];
+  watch.retries = 0;
+  watch.replies = (scenario.replies || []).slice();
+  var start = watch.now();
+  var fullMessages = 0;
+  var fullBytes = 0;
+  scenario.saves.forEach(function(batch, index) {
+    // Everything in a batch is saved before the watch answers anything.
+    batch.forEach(function(config) {
+      watch.save(config);
+      fullMessages++;
+      fullBytes += messageBytes(watch.fullSettings(config));
+    });
+    var last = index === scenario.saves.length - 1;
+    watch.settle(scenario.interrupt && !last, last ? undefined : scenario.hold);
+  });
+  var lastBatch = scenario.saves[scenario.saves.length - 1];
+  var final = watch.fullSettings(lastBatch[lastBatch.length - 1]);
+  var settled = Object.keys(final).every(function(key) {
+    return JSON.stringify(watch.settled[key]) === JSON.stringify(final[key]);
+  });
+  return {
+    scenario: name,
+    messages: watch.messages.length,
+    keys_sent: watch.messages.reduce(function(total, dict) { return total + Object.keys(dict).length; }, 0),
+    bytes_sent: watch.messages.reduce(function(total, dict) { return total + messageBytes(dict); }, 0),
+    retries: watch.retries,
+    elapsed_ms: watch.now() - start,
+    full_messages: fullMessages,
+    full_bytes: fullBytes,
+    watch_matches_last_save: settled
+  };
+}
+
+var names = process.argv.slice(2);
+(names.length ? names : Object.keys(SCENARIOS)).forEach(function(name) {
+  if (!SCENARIOS[name]) {
+    throw new Error('unknown scenario ' + name);
+  }
+  console.log(JSON.stringify(run(name)));
+});
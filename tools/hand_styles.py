@@ -0,0 +1,97 @@
+#!/usr/bin/env python
+#
+# Writes resources/data/hand_styles.bin, the hand shapes the watch loads with
+# resource_load_byte_range(). Edit STYLES below and rerun; the index of a
+# style in the list is the value of handStyleSetting.
+#
+#   python tools/hand_styles.py [--out resources/data/hand_styles.bin]
+#
+# Layout, little endian:
+#   'HS', format version (u8), style count (u8)
+#   per style: offset (u16), length (u16) of its record
+#   per record, for the hour, minute and second hand in turn:
+#     point count (u8), highlight point count (u8), length offset (i8),
+#     then x (i8), y (i8), anchor (u8) for every point and highlight point.
+# A CENTER point is placed as given. A TIP point's y is its distance back from
+# the tip, which the watch puts `length offset' pixels inside the bezel.
+
+import argparse
+import os
+import struct
+import sys
+
+ROOT_DIR = os.path.abspath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+FORMAT_VERSION = 1
+MAX_POINTS = 8
+MAX_HIGHLIGHT_POINTS = 2
+CENTER = 0
+TIP = 1
+
+
+def hand(points, highlight=(), length_offset=0):
+    return {'points': points, 'highlight': highlight, 'length_offset': length_offset}
+
+
+CLASSIC_HIGHLIGHT = ((0, 0, CENTER), (0, 10, TIP))
+STYLES = [
+    ('Classic', [
+        hand(((6, 0, CENTER), (0, 8, CENTER), (-6, 0, CENTER), (-4, 5, TIP), (0, 0, TIP), (4, 5, TIP)),
+             CLASSIC_HIGHLIGHT, length_offset=35),
+        hand(((4, 0, CENTER), (0, 8, CENTER), (-4, 0, CENTER), (-3, 5, TIP), (0, 0, TIP), (3, 5, TIP)),
+             CLASSIC_HIGHLIGHT),
+        hand(((4, 0, CENTER), (0, 8, CENTER), (-4, 0, CENTER), (-3, 5, TIP), (0, 0, TIP), (3, 5, TIP)),
+             CLASSIC_HIGHLIGHT),
+    ]),
+    ('Slim', [
+        hand(((3, 0, CENTER), (0, 6, CENTER), (-3, 0, CENTER), (-2, 4, TIP), (0, 0, TIP), (2, 4, TIP)),
+             CLASSIC_HIGHLIGHT, length_offset=40),
+        hand(((2, 0, CENTER), (0, 6, CENTER), (-2, 0, CENTER), (-2, 4, TIP), (0, 0, TIP), (2, 4, TIP)),
+             CLASSIC_HIGHLIGHT),
+        hand(((1, 16, CENTER), (-1, 16, CENTER), (-1, 0, TIP), (1, 0, TIP))),
+    ]),
+    ('Baton', [
+        hand(((5, 6, CENTER), (-5, 6, CENTER), (-5, 0, TIP), (5, 0, TIP)),
+             ((0, 0, CENTER), (0, 8, TIP)), length_offset=45),
+        hand(((4, 6, CENTER), (-4, 6, CENTER), (-4, 0, TIP), (4, 0, TIP)),
+             ((0, 0, CENTER), (0, 8, TIP)), length_offset=8),
+        hand(((3, 20, CENTER), (0, 24, CENTER), (-3, 20, CENTER), (-1, 12, CENTER), (-1, 0, TIP), (1, 0, TIP),
+              (1, 12, CENTER))),
+    ]),
+]
+
+
+def pack_hand(shape):
+    points, highlight = shape['points'], shape['highlight']
+    assert len(points) <= MAX_POINTS and len(highlight) in (0, MAX_HIGHLIGHT_POINTS)
+    data = struct.pack('<BBb', len(points), len(highlight), shape['length_offset'])
+    for x, y, anchor in tuple(points) + tuple(highlight):
+        data += struct.pack('<bbB', x, y, anchor)
+    return data
+
+
+def pack_styles(styles):
+    records = [b''.join(pack_hand(shape) for shape in hands) for _, hands in styles]
+    directory_end = 4 + 4 * len(records)
+    data = struct.pack('<2sBB', b'HS', FORMAT_VERSION, len(records))
+    offset = directory_end
+    for record in records:
+        data += struct.pack('<HH', offset, len(record))
+        offset += len(record)
+    return data + b''.join(records), records
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--out', default=os.path.join(ROOT_DIR, 'resources', 'data', 'hand_styles.bin'))
+    args = parser.parse_args(argv)
+    data, records = pack_styles(STYLES)
+    with open(args.out, 'wb') as output:
+        output.write(data)
+    for index, ((name, _), record) in enumerate(zip(STYLES, records)):
+        print('{} {}: {} bytes'.format(index, name, len(record)))
+    print('{} bytes total'.format(len(data)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+#
+# Checks that the watchface fits in a platform's app RAM with room to spare.
+# The code and statics are read from the built ELF, and the heap is the peak
+# the host bench measures for that platform. The wscript runs this after
+# linking the aplite binary and fails the build when the headroom is too small.
+#
+#   python tools/memory_budget.py [--platform aplite] [--elf build/aplite/pebble-app.elf]
+#
+# The bench's structs have 8-byte pointers where the watch has 4, so its heap
+# figure errs high; each allocation is also charged the firmware's block header.
+
+import argparse
+import json
+import os
+import struct
+import subprocess
+import sys
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.abspath(os.path.join(TOOLS_DIR, '..'))
+sys.path.insert(0, os.path.join(TOOLS_DIR, 'bench'))
+import bench  # noqa: E402
+
+# Everything the app gets: code, statics and heap.
+APP_RAM = {
+    'aplite': 24 * 1024,
+    'basalt': 64 * 1024,
+}
+HEAP_BLOCK_OVERHEAD = 8
+MIN_HEADROOM = 2048
+# Everything is allocated in init(); the other modes only tick more often.
+MODES = ('minutes', 'glance', 'schedule')
+SHF_ALLOC = 0x2
+
+
+# Sums the sections that are loaded into RAM, which on the watch includes the code.
+def static_bytes(elf_path):
+    with open(elf_path, 'rb') as elf:
+        data = elf.read()
+    if data[:4] != b'\x7fELF':
+        raise ValueError('{} is not an ELF file'.format(elf_path))
+    is_64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+    if is_64:
+        section_offset, = struct.unpack_from(endian + 'Q', data, 0x28)
+        entry_size, count = struct.unpack_from(endian + 'HH', data, 0x3a)
+        section = endian + 'IIQQQQ'
+    else:
+        section_offset, = struct.unpack_from(endian + 'I', data, 0x20)
+        entry_size, count = struct.unpack_from(endian + 'HH', data, 0x2e)
+        section = endian + 'IIIIII'
+    total = 0
+    for i in range(count):
+        _, _, flags, _, _, size = struct.unpack_from(section, data, section_offset + i * entry_size)
+        if flags & SHF_ALLOC:
+            total += size
+    return total
+
+
+def heap_bytes(platform, cc):
+    out_dir = os.path.join(ROOT_DIR, 'build', 'host_bench_' + platform)
+    binary = bench.build(cc, out_dir, platform)
+    peak = 0
+    for mode in MODES:
+        output = subprocess.check_output([binary, mode]).decode()
+        for line in output.splitlines():
+            counters = json.loads(line)
+            if counters['scope'] == 'init':
+                allocations = counters['heap_allocations']
+            peak = max(peak, counters['heap_bytes_peak'])
+    return peak + allocations * HEAP_BLOCK_OVERHEAD
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--platform', choices=sorted(APP_RAM), default='aplite')
+    parser.add_argument('--elf')
+    parser.add_argument('--cc', default=os.environ.get('CC_HOST', 'cc'))
+    parser.add_argument('--min-headroom', type=int, default=MIN_HEADROOM)
+    args = parser.parse_args(argv)
+    budget = APP_RAM[args.platform]
+    static = static_bytes(args.elf) if args.elf else 0
+    heap = heap_bytes(args.platform, args.cc)
+    headroom = budget - static - heap
+    print('{}: {} bytes code and statics{}, {} bytes heap, {} of {} bytes free'.format(
+        args.platform, static, '' if args.elf else ' (no --elf given)', heap, headroom, budget))
+    if headroom < args.min_headroom:
+        print('{}: over budget, needs at least {} bytes free'.format(args.platform, args.min_headroom))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))